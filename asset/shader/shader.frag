@@ -1,10 +1,10 @@
 #version 330 core
 
-out vec4 o_frag_color;
+in vec3 v_color;
 
-uniform vec3 u_color;
+out vec4 o_frag_color;
 
 void main()
 {
-    o_frag_color = vec4(u_color, 1.0);
+    o_frag_color = vec4(v_color, 1.0);
 }
@@ -3,11 +3,21 @@
 layout(location = 0) in vec3 a_pos;
 layout(location = 1) in vec3 a_normal;
 
-uniform mat4 u_model;
-uniform mat4 u_view;
-uniform mat4 u_projection;
+// per instance
+layout(location = 2) in mat4 a_model;
+layout(location = 6) in vec3 a_color;
+
+// per frame, shared by every program
+layout(std140) uniform Frame
+{
+    mat4 u_view;
+    mat4 u_projection;
+};
+
+out vec3 v_color;
 
 void main()
 {
-    gl_Position = u_projection * u_view * u_model * vec4(a_pos, 1.0);
+    gl_Position = u_projection * u_view * a_model * vec4(a_pos, 1.0);
+    v_color     = a_color;
 }
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <ecs/common.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdio>
+#include <print>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+    struct Result
+    {
+        std::string m_name;
+        std::size_t m_ops;
+        double      m_ns_per_op;
+
+        double ops_per_second() const { return 1e9 / m_ns_per_op; }
+    };
+
+    // every result reported so far, in order
+    inline std::vector<Result>& results()
+    {
+        static auto results = std::vector<Result>{};
+        return results;
+    }
+
+    /**
+     * @brief Prevent the compiler from optimizing away a value.
+     */
+    template <typename T>
+    void do_not_optimize(T const& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /**
+     * @brief Run a benchmark multiple times and take the fastest run.
+     *
+     * @param name Name of the benchmark.
+     * @param ops Number of operations done by a single invocation of `setup` + `fn`.
+     * @param setup Called before each run, not measured; its return value is passed to `fn`.
+     * @param fn The measured function.
+     * @param repeat Number of runs.
+     */
+    template <std::invocable Setup, std::invocable<std::invoke_result_t<Setup>&> Fn>
+    Result measure(std::string name, std::size_t ops, Setup&& setup, Fn&& fn, std::size_t repeat = 7)
+    {
+        using Nanos = std::chrono::duration<double, std::nano>;
+
+        auto best = Nanos::max();
+
+        for (auto i = 0uz; i < repeat; ++i) {
+            auto state = setup();
+
+            auto start = ecs::Clock::now();
+            fn(state);
+            auto end = ecs::Clock::now();
+
+            do_not_optimize(state);
+            best = std::min(best, std::chrono::duration_cast<Nanos>(end - start));
+        }
+
+        return { std::move(name), ops, best.count() / static_cast<double>(ops) };
+    }
+
+    inline void report(const Result& result)
+    {
+        std::println(
+            "{:<48} {:>10.2f} ns/op {:>14.0f} ops/s",
+            result.m_name,
+            result.m_ns_per_op,
+            result.ops_per_second()
+        );
+        results().push_back(result);
+    }
+
+    /**
+     * @brief Write results as a JSON document, to be compared across runs or storage backends by tools.
+     *
+     * The names are written as they are, they never contain characters that need escaping.
+     */
+    inline void write_json(std::FILE* file, std::span<const Result> results)
+    {
+        std::println(file, "{{");
+        std::println(file, R"(  "benchmarks": [)");
+        for (auto i = 0uz; i < results.size(); ++i) {
+            const auto& result = results[i];
+            std::println(
+                file,
+                R"(    {{ "name": "{}", "ops": {}, "ns_per_op": {:.3f}, "ops_per_second": {:.1f} }}{})",
+                result.m_name,
+                result.m_ops,
+                result.m_ns_per_op,
+                result.ops_per_second(),
+                i + 1 < results.size() ? "," : ""
+            );
+        }
+        std::println(file, "  ]");
+        std::println(file, "}}");
+    }
+}
@@ -0,0 +1,97 @@
+#include "bench.hpp"
+
+#include "spatial/aabb.hpp"
+#include "spatial/sweep_and_prune.hpp"
+
+#include <ecs/common.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <memory>
+#include <print>
+#include <random>
+#include <vector>
+
+namespace
+{
+    namespace spatial = nexus::spatial;
+
+    // bodies flying around like in nexus, at the density of its scene whatever their count
+    struct Scene
+    {
+        std::vector<ecs::Entity>   m_entities;
+        std::vector<glm::vec3>     m_positions;
+        std::vector<glm::vec3>     m_velocities;
+        std::vector<glm::vec3>     m_scales;
+        std::vector<spatial::Aabb> m_bounds;
+
+        std::unique_ptr<spatial::SweepAndPrune> m_broadphase = std::make_unique<spatial::SweepAndPrune>();
+
+        std::size_t m_pairs = 0;    // summed over the stepped frames
+
+        explicit Scene(std::size_t count)
+        {
+            auto half  = 125.0f * std::cbrt(static_cast<float>(count) / 5000.0f);
+            auto rng   = std::mt19937{ 42 };
+            auto pos   = std::uniform_real_distribution{ -half, half };
+            auto vel   = std::uniform_real_distribution{ -100.0f, 100.0f };
+            auto scale = std::uniform_real_distribution{ 1.0f, 4.0f };
+
+            for (auto i = 0uz; i < count; ++i) {
+                auto s = scale(rng);
+                m_entities.push_back(ecs::Entity::make(static_cast<ecs::Entity::Inner>(i), 0));
+                m_positions.push_back({ pos(rng), pos(rng), pos(rng) });
+                m_velocities.push_back(glm::vec3{ vel(rng), vel(rng), vel(rng) } / s);
+                m_scales.push_back(glm::vec3{ s });
+            }
+            m_bounds.resize(count);
+
+            step(0.0f);
+            m_pairs = 0;
+        }
+
+        void step(float dt)
+        {
+            for (auto i = 0uz; i < m_entities.size(); ++i) {
+                m_positions[i] += m_velocities[i] * dt;
+                m_bounds[i]     = spatial::cube_bounds(m_positions[i], m_scales[i]);
+            }
+
+            m_broadphase->update(m_entities, m_bounds);
+            m_pairs += m_broadphase->pairs().size();
+        }
+    };
+
+    // a frame being moving the bodies and finding the overlapping pairs
+    void run_collision_benchmarks(std::size_t count)
+    {
+        constexpr auto frames = 10uz;
+        constexpr auto dt     = 1.0f / 60.0f;
+
+        auto pairs = 0uz;
+        auto setup = [&] { return Scene{ count }; };
+        auto run   = [&](Scene& scene) {
+            for (auto i = 0uz; i < frames; ++i) {
+                scene.step(dt);
+            }
+            pairs = scene.m_pairs / frames;
+        };
+
+        auto result = bench::measure(std::format("collision/sap/{}", count), frames, setup, run, 3);
+        bench::report(result);
+        std::println("{:<48} {:>10} pairs/frame", "", pairs);
+    }
+}
+
+namespace bench
+{
+    void collision_benchmarks()
+    {
+        run_collision_benchmarks(5'000);
+        run_collision_benchmarks(50'000);
+        run_collision_benchmarks(500'000);
+    }
+}
@@ -0,0 +1,146 @@
+#include "bench.hpp"
+
+#include <ecs/component_array.hpp>
+#include <ecs/config.hpp>
+#include <ecs/util/fixed_array.hpp>
+
+#include <algorithm>
+#include <format>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    struct Vec3
+    {
+        float m_x, m_y, m_z;
+    };
+
+    struct Body
+    {
+        Vec3 m_velocity;
+        Vec3 m_acceleration;
+        Vec3 m_angular_velocity;
+    };
+
+    /**
+     * @brief The previous `ComponentArray` implementation using a pair of hash maps, kept as a baseline.
+     */
+    template <ecs::concepts::Component Comp>
+    class MapComponentArray
+    {
+    public:
+        // the baseline has no change ticks, the tick is only taken to share the interface
+        void insert_data(ecs::Entity entity, Comp component, ecs::Tick /* tick */)
+        {
+            auto index = m_size;
+
+            m_entity_to_index.emplace(entity, index);
+            m_index_to_entity.emplace(index, entity);
+            m_components[index] = component;
+
+            ++m_size;
+        }
+
+        void remove_data(ecs::Entity entity)
+        {
+            auto index_of_removed_entity = m_entity_to_index.at(entity);
+            auto index_of_last_element   = m_size - 1;
+
+            m_components[index_of_removed_entity] = m_components[index_of_last_element];
+
+            auto last_entity = m_index_to_entity.at(index_of_last_element);
+
+            m_entity_to_index.at(last_entity)             = index_of_removed_entity;
+            m_index_to_entity.at(index_of_removed_entity) = last_entity;
+
+            m_entity_to_index.erase(entity);
+            m_index_to_entity.erase(index_of_last_element);
+
+            --m_size;
+        }
+
+        Comp& get_data(ecs::Entity entity) { return m_components[m_entity_to_index.at(entity)]; }
+
+    private:
+        ecs::util::FixedArray<Comp, ecs::config::default_capacity> m_components = {};
+
+        std::unordered_map<ecs::Entity, std::size_t> m_entity_to_index = {};
+        std::unordered_map<std::size_t, ecs::Entity> m_index_to_entity = {};
+
+        std::size_t m_size = 0;
+    };
+
+    std::vector<ecs::Entity> shuffled_entities(std::size_t count)
+    {
+        auto entities = std::vector<ecs::Entity>{};
+        for (auto i = 0uz; i < count; ++i) {
+            entities.emplace_back(static_cast<ecs::Entity::Inner>(i));
+        }
+
+        auto rng = std::mt19937{ 42 };
+        std::ranges::shuffle(entities, rng);
+
+        return entities;
+    }
+
+    template <template <typename> typename Array>
+    void run_array_benchmarks(std::string_view name)
+    {
+        constexpr auto count = ecs::config::default_capacity;
+
+        auto entities = shuffled_entities(count);
+
+        auto empty  = [] { return std::make_unique<Array<Body>>(); };
+        auto filled = [&] {
+            auto array = std::make_unique<Array<Body>>();
+            for (auto entity : entities) {
+                array->insert_data(entity, Body{}, ecs::Tick{ 1 });
+            }
+            return array;
+        };
+
+        auto insert = [&](auto& array) {
+            for (auto entity : entities) {
+                array->insert_data(entity, Body{}, ecs::Tick{ 1 });
+            }
+        };
+
+        auto get = [&](auto& array) {
+            auto sum = 0.0f;
+            for (auto entity : entities) {
+                sum += array->get_data(entity).m_velocity.m_x;
+            }
+            bench::do_not_optimize(sum);
+        };
+
+        auto update = [&](auto& array) {
+            for (auto entity : entities) {
+                auto& body = array->get_data(entity);
+                body.m_velocity.m_x += body.m_acceleration.m_x;
+            }
+        };
+
+        auto remove = [&](auto& array) {
+            for (auto entity : entities) {
+                array->remove_data(entity);
+            }
+        };
+
+        bench::report(bench::measure(std::format("{}/insert/{}", name, count), count, empty, insert));
+        bench::report(bench::measure(std::format("{}/get/{}", name, count), count, filled, get));
+        bench::report(bench::measure(std::format("{}/update/{}", name, count), count, filled, update));
+        bench::report(bench::measure(std::format("{}/remove/{}", name, count), count, filled, remove));
+    }
+}
+
+namespace bench
+{
+    void component_array_benchmarks()
+    {
+        run_array_benchmarks<MapComponentArray>("component_array/unordered_map");
+        run_array_benchmarks<ecs::ComponentArray>("component_array/sparse_set");
+    }
+}
@@ -0,0 +1,211 @@
+#include "bench.hpp"
+
+#include <ecs/coordinator.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <random>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    struct Position
+    {
+        float m_x, m_y, m_z;
+    };
+
+    struct Velocity
+    {
+        float m_x, m_y, m_z;
+    };
+
+    struct Acceleration
+    {
+        float m_x, m_y, m_z;
+    };
+
+    struct Force
+    {
+        float m_x, m_y, m_z;
+    };
+
+    struct Scale
+    {
+        float m_x, m_y, m_z;
+    };
+
+    struct Color
+    {
+        float m_x, m_y, m_z;
+    };
+
+    // writes `First` from the others, so that every component of its signature is touched
+    template <typename Coordinator, typename First, typename... Rest>
+    struct IterateSystem : ecs::ISystem<Coordinator>
+    {
+        using Components = std::tuple<First, const Rest...>;
+
+        void update(Coordinator& coordinator, std::span<const ecs::Entity>, ecs::Duration) override
+        {
+            coordinator.template view<First, const Rest...>().each([](First& first, const Rest&... rest) {
+                first.m_x += (rest.m_x + ... + 1.0f);
+            });
+        }
+    };
+
+    template <typename Coordinator>
+    struct State
+    {
+        std::unique_ptr<Coordinator> m_coordinator;
+        std::vector<ecs::Entity>     m_entities;
+    };
+
+    // a setup making a coordinator with `count` entities that have the given components
+    template <typename Coordinator, typename... AddComps>
+    auto spawn(std::size_t count)
+    {
+        return [count] {
+            auto coordinator = std::make_unique<Coordinator>(count);
+            auto entities    = coordinator->create_entities(count);
+
+            if constexpr (sizeof...(AddComps) > 0) {
+                coordinator->template add_components<AddComps...>(entities, std::vector<AddComps>(count)...);
+            }
+
+            return State<Coordinator>{ std::move(coordinator), std::move(entities) };
+        };
+    }
+
+    // the basic operations of a coordinator, each op being done on one entity
+    template <typename Coordinator>
+    void run_ecs_benchmarks(std::string_view storage, std::size_t count)
+    {
+        constexpr auto frames = 10uz;
+
+        auto repeat = count < 100'000 ? 7uz : 3uz;
+        auto run    = [&](std::string_view name, std::size_t ops, auto&& setup, auto&& fn) {
+            auto full_name = std::format("ecs/{}/{}/{}", storage, name, count);
+            bench::report(bench::measure(std::move(full_name), ops, setup, fn, repeat));
+        };
+
+        auto create = [&](auto& state) {
+            for (auto i = 0uz; i < count; ++i) {
+                bench::do_not_optimize(state.m_coordinator->create_entity());
+            }
+        };
+
+        auto destroy = [&](auto& state) {
+            for (auto entity : state.m_entities) {
+                state.m_coordinator->destroy_entity(entity);
+            }
+        };
+
+        auto add = [&](auto& state) {
+            for (auto entity : state.m_entities) {
+                state.m_coordinator->add_component(entity, Position{});
+            }
+        };
+
+        auto remove = [&](auto& state) {
+            for (auto entity : state.m_entities) {
+                state.m_coordinator->template remove_component<Velocity>(entity);
+            }
+        };
+
+        // in a random order, read only so that no change tick is written
+        auto get = [&](auto& state) {
+            auto sum = 0.0f;
+            for (auto entity : state.m_entities) {
+                sum += state.m_coordinator->template get_component<const Position>(entity).m_x;
+            }
+            bench::do_not_optimize(sum);
+        };
+
+        // moves every entity to another signature and back
+        auto churn = [&](auto& state) {
+            for (auto entity : state.m_entities) {
+                state.m_coordinator->add_component(entity, Velocity{});
+                state.m_coordinator->template remove_component<Velocity>(entity);
+            }
+        };
+
+        auto iterate = [&](auto& state) {
+            for (auto i = 0uz; i < frames; ++i) {
+                state.m_coordinator->update(ecs::Duration{});
+            }
+        };
+
+        auto spawn_all = spawn<Coordinator, Position, Velocity, Acceleration, Force, Scale, Color>(count);
+
+        auto shuffled = [&] {
+            auto state = spawn_all();
+            std::ranges::shuffle(state.m_entities, std::mt19937{ 42 });
+            return state;
+        };
+
+        auto with_system = [&]<typename System>() {
+            return [&] {
+                auto state = spawn_all();
+                state.m_coordinator->template create_system<System>();
+                return state;
+            };
+        };
+
+        using Iterate1 = IterateSystem<Coordinator, Position>;
+        using Iterate3 = IterateSystem<Coordinator, Position, Velocity, Acceleration>;
+        using Iterate6 = IterateSystem<Coordinator, Position, Velocity, Acceleration, Force, Scale, Color>;
+
+        run("create", count, spawn<Coordinator>(0), create);
+        run("destroy", count, spawn<Coordinator, Position, Velocity, Color>(count), destroy);
+        run("add", count, spawn<Coordinator>(count), add);
+        run("remove", count, spawn<Coordinator, Position, Velocity>(count), remove);
+        run("get_random", count, shuffled, get);
+        run("iterate_1", count * frames, with_system.template operator()<Iterate1>(), iterate);
+        run("iterate_3", count * frames, with_system.template operator()<Iterate3>(), iterate);
+        run("iterate_6", count * frames, with_system.template operator()<Iterate6>(), iterate);
+        run("churn", count, spawn<Coordinator, Position>(count), churn);
+
+        auto snapshot = std::filesystem::temp_directory_path() / "simple-ecs-bench.snapshot";
+
+        auto save = [&](auto& state) {
+            bench::do_not_optimize(state.m_coordinator->save_snapshot(snapshot));
+        };
+
+        auto load = [&](auto& state) {
+            bench::do_not_optimize(state.m_coordinator->load_snapshot(snapshot));
+        };
+
+        // an empty coordinator to load the snapshot of all the entities into
+        auto saved = [&] {
+            auto state = spawn_all();
+            state.m_coordinator->save_snapshot(snapshot);
+            state.m_coordinator = std::make_unique<Coordinator>();
+            return state;
+        };
+
+        run("save", count, spawn_all, save);
+        run("load", count, saved, load);
+
+        std::filesystem::remove(snapshot);
+    }
+
+    using SparseSetCoordinator = ecs::Coordinator<Position, Velocity, Acceleration, Force, Scale, Color>;
+    using ArchetypeCoordinator =
+        ecs::ArchetypeCoordinator<Position, Velocity, Acceleration, Force, Scale, Color>;
+}
+
+namespace bench
+{
+    void ecs_benchmarks()
+    {
+        for (auto count : { 1'000uz, 10'000uz, 100'000uz, 1'000'000uz }) {
+            run_ecs_benchmarks<SparseSetCoordinator>("sparse_set", count);
+            run_ecs_benchmarks<ArchetypeCoordinator>("archetype", count);
+        }
+    }
+}
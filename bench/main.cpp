@@ -0,0 +1,90 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <print>
+#include <string_view>
+#include <vector>
+
+namespace bench
+{
+    void ecs_benchmarks();
+    void component_array_benchmarks();
+    void spawn_benchmarks();
+    void soa_benchmarks();
+    void physics_benchmarks();
+    void spatial_benchmarks();
+    void collision_benchmarks();
+}
+
+namespace
+{
+    struct Group
+    {
+        std::string_view m_name;
+        void (*m_run)();
+    };
+
+    constexpr Group groups[] = {
+        { "ecs", bench::ecs_benchmarks },
+        { "component_array", bench::component_array_benchmarks },
+        { "spawn", bench::spawn_benchmarks },
+        { "soa", bench::soa_benchmarks },
+        { "physics", bench::physics_benchmarks },
+        { "spatial", bench::spatial_benchmarks },
+        { "collision", bench::collision_benchmarks },
+    };
+
+    void usage(std::string_view program)
+    {
+        std::println(stderr, "usage: {} [--json <file>] [group...]", program);
+        std::print(stderr, "groups:");
+        for (const auto& group : groups) {
+            std::print(stderr, " {}", group.m_name);
+        }
+        std::println(stderr, "");
+    }
+}
+
+// runs every group, or only the named ones; `--json` also writes the results to a file
+int main(int argc, char** argv)
+{
+    auto json     = static_cast<const char*>(nullptr);
+    auto selected = std::vector<std::string_view>{};
+
+    for (auto i = 1; i < argc; ++i) {
+        auto arg = std::string_view{ argv[i] };
+        if (arg == "--json" and i + 1 < argc) {
+            json = argv[++i];
+        } else if (arg.starts_with("-")) {
+            usage(argv[0]);
+            return 1;
+        } else {
+            selected.push_back(arg);
+        }
+    }
+
+    auto is_group = [](std::string_view name) {
+        return std::ranges::find(groups, name, &Group::m_name) != std::ranges::end(groups);
+    };
+    if (not std::ranges::all_of(selected, is_group)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    for (const auto& group : groups) {
+        if (selected.empty() or std::ranges::find(selected, group.m_name) != selected.end()) {
+            group.m_run();
+        }
+    }
+
+    if (json != nullptr) {
+        auto* file = std::fopen(json, "w");
+        if (file == nullptr) {
+            std::println(stderr, "failed to open '{}' for writing", json);
+            return 1;
+        }
+        bench::write_json(file, bench::results());
+        std::fclose(file);
+    }
+}
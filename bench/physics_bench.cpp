@@ -0,0 +1,114 @@
+#include "bench.hpp"
+
+#include "system/physics_kernel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <print>
+#include <random>
+#include <vector>
+
+namespace
+{
+    namespace physics = nexus::physics;
+
+    // every coordinate stream of the bodies, in the order of the fields of `physics::Bodies`
+    struct World
+    {
+        static constexpr std::size_t stream_count = 19;
+
+        std::array<std::vector<float>, stream_count> m_streams;
+
+        physics::Bodies bodies()
+        {
+            auto stream = [&](std::size_t index) { return m_streams[index].data(); };
+            return {
+                .m_position         = { stream(0), stream(1), stream(2) },
+                .m_velocity         = { stream(3), stream(4), stream(5) },
+                .m_acceleration     = { stream(6), stream(7), stream(8) },
+                .m_gravity          = { stream(9), stream(10), stream(11) },
+                .m_angular_velocity = { stream(12), stream(13), stream(14) },
+                .m_rotation         = { stream(15), stream(16), stream(17), stream(18) },
+                .m_count            = m_streams[0].size(),
+            };
+        }
+    };
+
+    World make_world(std::size_t count)
+    {
+        auto rng   = std::mt19937{ 42 };
+        auto dist  = std::uniform_real_distribution{ -100.0f, 100.0f };
+        auto world = World{};
+
+        for (auto& stream : world.m_streams) {
+            stream.resize(count);
+            std::ranges::generate(stream, [&] { return dist(rng); });
+        }
+
+        return world;
+    }
+
+    // the largest difference of any coordinate from the scalar kernel after a single step
+    float max_difference(physics::Isa isa, std::size_t count, float dt)
+    {
+        auto expected = make_world(count);
+        auto actual   = expected;
+
+        physics::kernel(physics::Isa::Scalar)(expected.bodies(), dt);
+        physics::kernel(isa)(actual.bodies(), dt);
+
+        auto max = 0.0f;
+        for (auto s = 0uz; s < World::stream_count; ++s) {
+            for (auto i = 0uz; i < count; ++i) {
+                auto lhs = actual.m_streams[s][i];
+                auto rhs = expected.m_streams[s][i];
+                max      = std::max(max, std::abs(lhs - rhs) / std::max(1.0f, std::abs(rhs)));
+            }
+        }
+        return max;
+    }
+
+    // integrating bodies with every kernel the cpu supports
+    void run_physics_benchmarks(std::size_t count)
+    {
+        constexpr auto frames = 10uz;
+        constexpr auto dt     = 1.0f / 60.0f;
+
+        using enum physics::Isa;
+
+        for (auto isa : { Scalar, Sse, Avx2, Avx512 }) {
+            if (not physics::is_supported(isa)) {
+                continue;
+            }
+
+            if (auto diff = max_difference(isa, count, dt); diff > physics::tolerance) {
+                auto name = physics::name(isa);
+                std::println(stderr, "physics/{}: differs from scalar by {} (> {})", name, diff, physics::tolerance);
+            }
+
+            auto setup     = [&] { return make_world(count); };
+            auto integrate = [&](World& world) {
+                auto kernel = physics::kernel(isa);
+                for (auto i = 0uz; i < frames; ++i) {
+                    kernel(world.bodies(), dt);
+                }
+            };
+
+            auto name = std::format("physics/{}/{}", physics::name(isa), count);
+            bench::report(bench::measure(name, count * frames, setup, integrate));
+        }
+    }
+}
+
+namespace bench
+{
+    void physics_benchmarks()
+    {
+        run_physics_benchmarks(10'000);
+        run_physics_benchmarks(100'000);
+        run_physics_benchmarks(1'000'000);
+    }
+}
@@ -0,0 +1,112 @@
+#include "bench.hpp"
+
+#include <ecs/coordinator.hpp>
+#include <ecs/soa.hpp>
+
+#include <format>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    struct Vec3
+    {
+        float m_x, m_y, m_z;
+    };
+
+    struct Quat
+    {
+        float m_w, m_x, m_y, m_z;
+    };
+
+    // a fat component of which the benchmarked loop only touches two fields
+    struct Body
+    {
+        Vec3 m_position;
+        Vec3 m_velocity;
+        Vec3 m_scale;
+        Quat m_rotation;
+        Vec3 m_color;
+    };
+
+    // the same fields, stored field by field
+    struct SoaBody
+    {
+        Vec3 m_position;
+        Vec3 m_velocity;
+        Vec3 m_scale;
+        Quat m_rotation;
+        Vec3 m_color;
+    };
+}
+
+template <>
+struct ecs::SoaLayout<SoaBody>
+    : ecs::SoaFields<
+          &SoaBody::m_position,
+          &SoaBody::m_velocity,
+          &SoaBody::m_scale,
+          &SoaBody::m_rotation,
+          &SoaBody::m_color>
+{
+};
+
+namespace
+{
+    void integrate(Vec3& position, const Vec3& velocity, float dt)
+    {
+        position.m_x += velocity.m_x * dt;
+        position.m_y += velocity.m_y * dt;
+        position.m_z += velocity.m_z * dt;
+    }
+
+    // integrating the position of every entity, with the component stored whole or field by field
+    template <template <typename...> typename Coordinator>
+    void run_soa_benchmarks(std::string_view name)
+    {
+        constexpr auto count  = 1'000'000uz;
+        constexpr auto frames = 10uz;
+        constexpr auto dt     = 1.0f / 60.0f;
+
+        auto setup = [&]<typename Comp>() {
+            auto coordinator = std::make_unique<Coordinator<Comp>>(count);
+            auto entities    = coordinator->create_entities(count);
+            auto components  = std::vector<Comp>(count, Comp{ .m_velocity = { 1.0f, 2.0f, 3.0f } });
+            coordinator->template add_components<Comp>(entities, components);
+            return coordinator;
+        };
+
+        auto aos = [&](auto& coordinator) {
+            for (auto i = 0uz; i < frames; ++i) {
+                coordinator->template view<Body>().each([&](Body& body) {
+                    integrate(body.m_position, body.m_velocity, dt);
+                });
+            }
+        };
+
+        auto soa = [&](auto& coordinator) {
+            for (auto i = 0uz; i < frames; ++i) {
+                coordinator->template view<SoaBody>().each([&](ecs::SoaRef<SoaBody> body) {
+                    integrate(body.get<&SoaBody::m_position>(), body.get<&SoaBody::m_velocity>(), dt);
+                });
+            }
+        };
+
+        auto setup_aos = [&] { return setup.template operator()<Body>(); };
+        auto setup_soa = [&] { return setup.template operator()<SoaBody>(); };
+
+        auto ops = count * frames;
+        bench::report(bench::measure(std::format("{}/aos/{}", name, count), ops, setup_aos, aos));
+        bench::report(bench::measure(std::format("{}/soa/{}", name, count), ops, setup_soa, soa));
+    }
+}
+
+namespace bench
+{
+    void soa_benchmarks()
+    {
+        run_soa_benchmarks<ecs::Coordinator>("soa/sparse_set");
+        run_soa_benchmarks<ecs::ArchetypeCoordinator>("soa/archetype");
+    }
+}
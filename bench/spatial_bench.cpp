@@ -0,0 +1,90 @@
+#include "bench.hpp"
+
+#include "spatial/hash_grid.hpp"
+
+#include <ecs/common.hpp>
+
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <format>
+#include <random>
+#include <vector>
+
+namespace
+{
+    namespace spatial = nexus::spatial;
+
+    std::vector<glm::vec3> make_positions(std::size_t count)
+    {
+        auto rng       = std::mt19937{ 42 };
+        auto dist      = std::uniform_real_distribution{ -125.0f, 125.0f };
+        auto positions = std::vector<glm::vec3>(count);
+
+        for (auto& position : positions) {
+            position = { dist(rng), dist(rng), dist(rng) };
+        }
+
+        return positions;
+    }
+
+    // every agent looking for its neighbors, through the grid and by scanning every other agent
+    void run_spatial_benchmarks(std::size_t count)
+    {
+        constexpr auto radius = 10.0f;
+
+        auto positions = make_positions(count);
+
+        auto setup = [&] {
+            auto grid = spatial::HashGrid{ radius };
+            for (auto i = 0uz; i < count; ++i) {
+                grid.update(ecs::Entity::make(static_cast<ecs::Entity::Inner>(i), 0), positions[i]);
+            }
+            return grid;
+        };
+
+        auto grid_query = [&](spatial::HashGrid& grid) {
+            auto found = 0uz;
+            for (const auto& position : positions) {
+                for (auto entity : grid.query_radius(position, radius)) {
+                    found += entity.index() & 1;
+                }
+            }
+            bench::do_not_optimize(found);
+        };
+
+        auto scan = [&](spatial::HashGrid&) {
+            auto found = 0uz;
+            for (const auto& position : positions) {
+                for (auto i = 0uz; i < count; ++i) {
+                    auto offset = positions[i] - position;
+                    if (glm::dot(offset, offset) <= radius * radius) {
+                        found += i & 1;
+                    }
+                }
+            }
+            bench::do_not_optimize(found);
+        };
+
+        auto moved = make_positions(count);
+        auto move  = [&](spatial::HashGrid& grid) {
+            for (auto i = 0uz; i < count; ++i) {
+                grid.update(ecs::Entity::make(static_cast<ecs::Entity::Inner>(i), 0), moved[i]);
+            }
+        };
+
+        bench::report(bench::measure(std::format("spatial/grid_radius/{}", count), count, setup, grid_query));
+        bench::report(bench::measure(std::format("spatial/scan_radius/{}", count), count, setup, scan, 1));
+        bench::report(bench::measure(std::format("spatial/grid_update/{}", count), count, setup, move));
+    }
+}
+
+namespace bench
+{
+    void spatial_benchmarks()
+    {
+        run_spatial_benchmarks(1'000);
+        run_spatial_benchmarks(10'000);
+    }
+}
@@ -0,0 +1,96 @@
+#include "bench.hpp"
+
+#include <ecs/coordinator.hpp>
+
+#include <format>
+#include <memory>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    struct Position
+    {
+        float m_x, m_y, m_z;
+    };
+
+    struct Velocity
+    {
+        float m_x, m_y, m_z;
+    };
+
+    struct Mass
+    {
+        float m_value;
+    };
+
+    struct Color
+    {
+        float m_r, m_g, m_b;
+    };
+
+    template <typename Coordinator>
+    struct MoveSystem : ecs::ISystem<Coordinator>
+    {
+        using Components = std::tuple<const Velocity, Position>;
+
+        void update(Coordinator&, std::span<const ecs::Entity>, ecs::Duration) override { }
+    };
+
+    template <typename Coordinator>
+    struct DrawSystem : ecs::ISystem<Coordinator>
+    {
+        using Components = std::tuple<const Position, const Color>;
+
+        void update(Coordinator&, std::span<const ecs::Entity>, ecs::Duration) override { }
+    };
+
+    // spawning entities into a coordinator that has systems to keep up to date
+    template <typename Coordinator>
+    void run_spawn_benchmarks(std::string_view name)
+    {
+        constexpr auto count = ecs::config::default_capacity - 1;
+
+        auto setup = [] {
+            auto coordinator = std::make_unique<Coordinator>();
+            coordinator->template create_system<MoveSystem<Coordinator>>();
+            coordinator->template create_system<DrawSystem<Coordinator>>();
+            return coordinator;
+        };
+
+        auto one_by_one = [&](auto& coordinator) {
+            for (auto i = 0uz; i < count; ++i) {
+                auto entity = coordinator->create_entity();
+                coordinator->add_component_tuple(
+                    entity,
+                    std::tuple{ Position{}, Velocity{ 1.0f, 0.0f, 0.0f }, Mass{ 1.0f }, Color{} }
+                );
+            }
+        };
+
+        auto bulk = [&](auto& coordinator) {
+            auto positions  = std::vector<Position>(count);
+            auto velocities = std::vector<Velocity>(count, Velocity{ 1.0f, 0.0f, 0.0f });
+            auto masses     = std::vector<Mass>(count, Mass{ 1.0f });
+            auto colors     = std::vector<Color>(count);
+
+            auto entities = coordinator->create_entities(count);
+            coordinator->template add_components<Position, Velocity, Mass, Color>(
+                entities, positions, velocities, masses, colors
+            );
+        };
+
+        bench::report(bench::measure(std::format("{}/one_by_one/{}", name, count), count, setup, one_by_one));
+        bench::report(bench::measure(std::format("{}/bulk/{}", name, count), count, setup, bulk));
+    }
+}
+
+namespace bench
+{
+    void spawn_benchmarks()
+    {
+        run_spawn_benchmarks<ecs::Coordinator<Position, Velocity, Mass, Color>>("spawn/sparse_set");
+        run_spawn_benchmarks<ecs::ArchetypeCoordinator<Position, Velocity, Mass, Color>>("spawn/archetype");
+    }
+}
@@ -0,0 +1,462 @@
+#pragma once
+
+#include "ecs/common.hpp"
+#include "ecs/concepts.hpp"
+#include "ecs/config.hpp"
+#include "ecs/snapshot.hpp"
+#include "ecs/soa.hpp"
+#include "ecs/util/concepts.hpp"
+#include "ecs/util/maybe_owned.hpp"
+#include "ecs/util/meta.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <vector>
+
+namespace ecs
+{
+    namespace detail
+    {
+        // the columns a component is stored in: a single one, none for a tag, or one per field
+        template <concepts::Component Comp>
+        struct ColumnsOf
+        {
+            static constexpr std::size_t count = 1;
+
+            static constexpr std::array<std::size_t, 1> sizes  = { concepts::Tag<Comp> ? 0 : sizeof(Comp) };
+            static constexpr std::array<std::size_t, 1> aligns = { alignof(Comp) };
+
+            static std::array<std::size_t, 1> offsets() { return { 0 }; }
+        };
+
+        template <concepts::SoaComponent Comp>
+        struct ColumnsOf<Comp>
+        {
+            static_assert(lists_every_member<SoaLayout<Comp>>());
+
+            static constexpr std::size_t count = SoaLayout<Comp>::field_count;
+
+            static constexpr auto sizes  = SoaLayout<Comp>::field_sizes;
+            static constexpr auto aligns = SoaLayout<Comp>::field_aligns;
+
+            static const auto& offsets() { return SoaLayout<Comp>::field_offsets(); }
+        };
+    }
+
+    /**
+     * @brief A table of entities sharing the same signature.
+     *
+     * Rows are stored in fixed-size chunks, each chunk holds one column per component in the signature plus
+     * a column of the entities themselves. The columns of a chunk are contiguous arrays, so iterating a chunk
+     * touches only the memory of the components that are being read. Tags have zero-width columns: they take
+     * no room in the chunk, the signature alone tells whether the rows have them. A component with a
+     * structure-of-arrays layout has a column per field instead.
+     *
+     * The ticks of the components are kept outside of the chunks, an array per component indexed by row, so
+     * iterating the components doesn't read them.
+     *
+     * @tparam Comps All the components known to the storage, the bit `i` of the signature corresponds to the
+     * `i`-th component.
+     */
+    template <concepts::Component... Comps>
+        requires util::Unique<Comps...>
+    class Archetype
+    {
+    public:
+        static constexpr std::size_t npos       = std::numeric_limits<std::size_t>::max();
+        static constexpr std::size_t chunk_size = config::archetype_chunk_size;
+        static constexpr std::size_t alignment  = config::archetype_chunk_alignment;
+
+        static constexpr std::size_t component_count = sizeof...(Comps);
+        static constexpr std::size_t column_count    = (detail::ColumnsOf<Comps>::count + ...);
+
+        static_assert(((alignof(Comps) <= alignment) and ...), "Component alignment is larger than chunk's");
+
+        // a column of a component, or of a field of a component
+        struct Column
+        {
+            std::size_t m_component;
+            std::size_t m_size;
+            std::size_t m_align;
+        };
+
+        static constexpr std::array<Column, column_count> columns = [] {
+            auto result = std::array<Column, column_count>{};
+            auto column = 0uz;
+            auto comp   = 0uz;
+            auto add    = [&]<typename Comp>() {
+                using Info = detail::ColumnsOf<Comp>;
+                for (auto i = 0uz; i < Info::count; ++i) {
+                    result[column++] = { comp, Info::sizes[i], Info::aligns[i] };
+                }
+                ++comp;
+            };
+            (add.template operator()<Comps>(), ...);
+            return result;
+        }();
+
+        // whether component `i` is a tag, which has no value and thus no ticks
+        static constexpr std::array<bool, component_count> tags = { concepts::Tag<Comps>... };
+
+        // the columns of component `i` are the range [first_columns[i], first_columns[i + 1])
+        static constexpr std::array<std::size_t, component_count + 1> first_columns = [] {
+            auto result = std::array<std::size_t, component_count + 1>{};
+            auto counts = std::array{ detail::ColumnsOf<Comps>::count... };
+            for (auto i = 0uz; i < component_count; ++i) {
+                result[i + 1] = result[i] + counts[i];
+            }
+            return result;
+        }();
+
+        explicit Archetype(Signature signature)
+            : m_signature{ signature }
+        {
+            m_offsets.fill(npos);
+            m_add_edges.fill(npos);
+            m_remove_edges.fill(npos);
+
+            auto row_size = sizeof(Entity);
+            for (const auto& column : columns) {
+                if (has_column(column.m_component)) {
+                    row_size += column.m_size;
+                }
+            }
+
+            // start from the optimistic capacity then shrink it until the padding fits as well
+            m_capacity = chunk_size / row_size;
+            while (m_capacity > 0 and not layout(m_capacity)) {
+                --m_capacity;
+            }
+
+            assert(m_capacity > 0 and "Components too large to fit into a single chunk");
+        }
+
+        Signature   signature() const noexcept { return m_signature; }
+        std::size_t size() const noexcept { return m_size; }
+        bool        empty() const noexcept { return m_size == 0; }
+
+        std::size_t chunk_capacity() const noexcept { return m_capacity; }
+        std::size_t chunk_count() const noexcept { return (m_size + m_capacity - 1) / m_capacity; }
+
+        // number of rows used in a chunk
+        std::size_t chunk_rows(std::size_t chunk) const noexcept
+        {
+            return std::min(m_capacity, m_size - chunk * m_capacity);
+        }
+
+        bool has_column(std::size_t comp_index) const noexcept
+        {
+            return m_signature.test(Signature{ config::SignatureInner{ 1 } << comp_index });
+        }
+
+        bool has_ticks(std::size_t comp_index) const noexcept
+        {
+            return has_column(comp_index) and not tags[comp_index];
+        }
+
+        /**
+         * @brief Append a row for an entity.
+         *
+         * The component columns of the row are left uninitialized and its ticks zeroed, the caller must fill
+         * them.
+         *
+         * @return The index of the new row.
+         */
+        std::size_t push(Entity entity)
+        {
+            auto row = m_size;
+            if (row == m_chunks.size() * m_capacity) {
+                m_chunks.push_back(util::own(std::make_unique_for_overwrite<Chunk>()));
+            }
+
+            ++m_size;
+            entity_slot(row) = entity;
+
+            for (auto i = 0uz; i < component_count; ++i) {
+                if (has_ticks(i)) {
+                    m_ticks[i].emplace_back();
+                }
+            }
+
+            return row;
+        }
+
+        // release the chunks past the last used one
+        void shrink_to_fit()
+        {
+            m_chunks.resize(chunk_count());
+            m_chunks.shrink_to_fit();
+
+            for (auto& ticks : m_ticks) {
+                ticks.shrink_to_fit();
+            }
+        }
+
+        /**
+         * @brief Remove a row by moving the last row into its place.
+         *
+         * @return The entity that now occupies `row`, empty if the removed row was the last one.
+         */
+        std::optional<Entity> swap_remove(std::size_t row)
+        {
+            assert(row < m_size and "Row out of range");
+
+            auto last = m_size - 1;
+            --m_size;
+
+            for (auto i = 0uz; i < component_count; ++i) {
+                if (has_ticks(i)) {
+                    m_ticks[i][row] = m_ticks[i][last];
+                    m_ticks[i].pop_back();
+                }
+            }
+
+            if (row == last) {
+                return std::nullopt;
+            }
+
+            for (auto i = 0uz; i < column_count; ++i) {
+                if (m_offsets[i] != npos) {
+                    std::memcpy(column_at(i, row), column_at(i, last), columns[i].m_size);
+                }
+            }
+
+            auto moved       = entity_at(last);
+            entity_slot(row) = moved;
+
+            return moved;
+        }
+
+        Entity entity_at(std::size_t row) const noexcept
+        {
+            return entities(row / m_capacity)[row % m_capacity];
+        }
+
+        std::byte* column_at(std::size_t column, std::size_t row) noexcept
+        {
+            assert(m_offsets[column] != npos and "Archetype does not have the column");
+            auto chunk = row / m_capacity;
+            auto slot  = row % m_capacity;
+            return m_chunks[chunk]->m_bytes + m_offsets[column] + slot * columns[column].m_size;
+        }
+
+        // the bytes of a component stored whole, i.e. without a structure-of-arrays layout
+        std::byte* component_at(std::size_t comp_index, std::size_t row) noexcept
+        {
+            assert(first_columns[comp_index + 1] - first_columns[comp_index] == 1 and "Component is split");
+            return column_at(first_columns[comp_index], row);
+        }
+
+        // write a component into a row, scattering its fields into their columns
+        void write(std::size_t comp_index, std::size_t row, const void* value) noexcept
+        {
+            const auto& offsets = column_offsets();
+            const auto* bytes   = static_cast<const std::byte*>(value);
+
+            for (auto i = first_columns[comp_index]; i < first_columns[comp_index + 1]; ++i) {
+                std::memcpy(column_at(i, row), bytes + offsets[i], columns[i].m_size);
+            }
+        }
+
+        // copy a component and its ticks from a row into a row of another archetype that has it too
+        void copy_to(std::size_t comp_index, std::size_t row, Archetype& dest, std::size_t dest_row) noexcept
+        {
+            for (auto i = first_columns[comp_index]; i < first_columns[comp_index + 1]; ++i) {
+                std::memcpy(dest.column_at(i, dest_row), column_at(i, row), columns[i].m_size);
+            }
+
+            if (has_ticks(comp_index)) {
+                dest.ticks(comp_index, dest_row) = ticks(comp_index, row);
+            }
+        }
+
+        template <typename Self>
+        auto&& ticks(this Self&& self, std::size_t comp_index, std::size_t row) noexcept
+        {
+            assert(self.has_ticks(comp_index) and "Archetype does not have ticks for the component");
+            return std::forward<Self>(self).m_ticks[comp_index][row];
+        }
+
+        // mark the components of every row as added at `tick`
+        void reset_ticks(Tick tick) noexcept
+        {
+            for (auto& ticks : m_ticks) {
+                std::ranges::fill(ticks, ComponentTicks{ tick, tick });
+            }
+        }
+
+        const Entity* entities(std::size_t chunk) const noexcept
+        {
+            return std::launder(reinterpret_cast<const Entity*>(m_chunks[chunk]->m_bytes));
+        }
+
+        /**
+         * @brief Get the column of a component inside a chunk.
+         *
+         * @tparam Comp The component type, the archetype must have it. Tags have no column to get, and the
+         * components with a structure-of-arrays layout have a column per field instead.
+         */
+        template <concepts::Component Comp>
+            requires util::OneOf<Comp, Comps...> and (not concepts::Tag<Comp>)
+                 and (not concepts::SoaComponent<Comp>)
+        Comp* column(std::size_t chunk) noexcept
+        {
+            constexpr auto column = first_columns[util::PackTraits<Comps...>::template index<Comp>()];
+            return std::launder(reinterpret_cast<Comp*>(column_bytes(column, chunk)));
+        }
+
+        /**
+         * @brief Get the field columns of a component with a structure-of-arrays layout inside a chunk.
+         *
+         * @return A tuple of pointers to the first row of each field's column, in the order of the layout.
+         */
+        template <concepts::SoaComponent Comp>
+            requires util::OneOf<Comp, Comps...>
+        typename SoaRef<Comp>::Pointers field_columns(std::size_t chunk) noexcept
+        {
+            constexpr auto first = first_columns[util::PackTraits<Comps...>::template index<Comp>()];
+
+            auto handler = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                return typename SoaRef<Comp>::Pointers{ std::launder(
+                    reinterpret_cast<typename SoaLayout<Comp>::template FieldAt<Is>*>(
+                        column_bytes(first + Is, chunk)
+                    )
+                )... };
+            };
+            return handler(std::make_index_sequence<SoaLayout<Comp>::field_count>{});
+        }
+
+        // the row count and the chunks as they are, then the ticks of each component
+        void save(SnapshotWriter& writer) const
+        {
+            writer.write(static_cast<std::uint64_t>(m_size));
+
+            writer.template begin_array<Chunk>(chunk_count());
+            for (auto chunk = 0uz; chunk < chunk_count(); ++chunk) {
+                writer.write_bytes(std::as_bytes(std::span{ m_chunks[chunk]->m_bytes }));
+            }
+
+            for (const auto& ticks : m_ticks) {
+                writer.write_array(std::span{ ticks });
+            }
+        }
+
+        /**
+         * @brief Replace the rows with the ones saved, using the chunks of the snapshot in place.
+         *
+         * The archetype must have the signature it was saved with, the layout of the chunks follows from it.
+         *
+         * @return False if the snapshot is corrupted.
+         */
+        bool load(SnapshotReader& reader)
+        {
+            auto size   = reader.read<std::uint64_t>();
+            auto chunks = reader.template read_array<Chunk>();
+
+            // exactly the chunks needed for the rows
+            auto capacity = chunks.size() * m_capacity;
+            auto rows_fit = size <= capacity and size + m_capacity > capacity;
+            if (not reader.ok() or not rows_fit) {
+                return false;
+            }
+
+            m_chunks.clear();
+            for (auto& chunk : chunks) {
+                m_chunks.push_back(util::borrow<Chunk>(&chunk));
+            }
+            m_owner = reader.owner();
+            m_size  = size;
+
+            for (auto i = 0uz; i < component_count; ++i) {
+                auto ticks = reader.template read_array<ComponentTicks>();
+                if (ticks.size() != (has_ticks(i) ? m_size : 0)) {
+                    return false;
+                }
+                m_ticks[i].assign(ticks.begin(), ticks.end());
+            }
+
+            return reader.ok();
+        }
+
+        // cached transitions to the archetype that has one more or one less component
+        std::size_t& add_edge(std::size_t comp_index) noexcept { return m_add_edges[comp_index]; }
+        std::size_t& remove_edge(std::size_t comp_index) noexcept { return m_remove_edges[comp_index]; }
+
+    private:
+        struct alignas(alignment) Chunk
+        {
+            std::byte m_bytes[chunk_size];
+        };
+
+        static std::size_t align_up(std::size_t value, std::size_t align)
+        {
+            return (value + align - 1) / align * align;
+        }
+
+        // byte offset of each column's value inside its component
+        static const std::array<std::size_t, column_count>& column_offsets()
+        {
+            static const auto offsets = [] {
+                auto result = std::array<std::size_t, column_count>{};
+                auto comp   = 0uz;
+                auto add    = [&]<typename Comp>() {
+                    const auto& field_offsets = detail::ColumnsOf<Comp>::offsets();
+                    std::ranges::copy(field_offsets, result.begin() + first_columns[comp++]);
+                };
+                (add.template operator()<Comps>(), ...);
+                return result;
+            }();
+            return offsets;
+        }
+
+        std::byte* column_bytes(std::size_t column, std::size_t chunk) noexcept
+        {
+            assert(m_offsets[column] != npos and "Archetype does not have the column");
+            return m_chunks[chunk]->m_bytes + m_offsets[column];
+        }
+
+        Entity& entity_slot(std::size_t row) noexcept
+        {
+            auto* entities = reinterpret_cast<Entity*>(m_chunks[row / m_capacity]->m_bytes);
+            return std::launder(entities)[row % m_capacity];
+        }
+
+        // compute column offsets for the given capacity, returns false if they don't fit into a chunk
+        bool layout(std::size_t capacity)
+        {
+            auto offset = sizeof(Entity) * capacity;
+
+            for (auto i = 0uz; i < column_count; ++i) {
+                if (has_column(columns[i].m_component)) {
+                    offset       = align_up(offset, columns[i].m_align);
+                    m_offsets[i] = offset;
+                    offset      += columns[i].m_size * capacity;
+                }
+            }
+
+            return offset <= chunk_size;
+        }
+
+        Signature   m_signature;
+        std::size_t m_capacity = 0;
+        std::size_t m_size     = 0;
+
+        std::array<std::size_t, column_count>    m_offsets;
+        std::array<std::size_t, component_count> m_add_edges;
+        std::array<std::size_t, component_count> m_remove_edges;
+
+        std::vector<util::MaybeOwned<Chunk>> m_chunks;
+        std::shared_ptr<const void>          m_owner;    // of the chunks adopted from a snapshot
+
+        // per component, indexed by row; empty for the components the archetype doesn't have, and for tags
+        std::array<std::vector<ComponentTicks>, component_count> m_ticks;
+    };
+}
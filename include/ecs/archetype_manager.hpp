@@ -0,0 +1,648 @@
+#pragma once
+
+#include "ecs/archetype.hpp"
+#include "ecs/common.hpp"
+#include "ecs/component_slot.hpp"
+#include "ecs/concepts.hpp"
+#include "ecs/config.hpp"
+#include "ecs/signature_mapper.hpp"
+#include "ecs/snapshot.hpp"
+#include "ecs/soa.hpp"
+#include "ecs/sparse_set.hpp"
+#include "ecs/tag.hpp"
+#include "ecs/util/concepts.hpp"
+#include "ecs/util/paged_array.hpp"
+#include "ecs/util/meta.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ecs
+{
+    /**
+     * @brief Component storage that groups entities with the same signature into archetypes.
+     *
+     * An alternative to `ComponentManager`: every component of an entity lives in the same row of the same
+     * chunk, so a system that touches several components of an entity reads neighbouring memory instead of
+     * jumping between unrelated arrays. The price is that adding or removing a component moves the entity's
+     * row into another archetype.
+     */
+    template <concepts::Component... Comps>
+        requires util::Unique<Comps...>
+    class ArchetypeManager
+    {
+    public:
+        using Components = std::tuple<Comps...>;
+        using Archetype  = ecs::Archetype<Comps...>;
+
+        ArchetypeManager() = default;
+
+        explicit ArchetypeManager(std::size_t capacity) { reserve(capacity); }
+
+        // reserve room for the bookkeeping of the given number of entities
+        void reserve(std::size_t capacity) { m_records.reserve(capacity); }
+
+        // release the chunks left empty by removed rows, e.g. after destroying many entities
+        void shrink_to_fit()
+        {
+            for (auto& archetype : m_archetypes) {
+                archetype->shrink_to_fit();
+            }
+        }
+
+        template <util::OneOf<Comps...> Comp>
+        void add_component(Entity entity, Comp component, Tick tick)
+        {
+            constexpr auto comp_index = index_of<Comp>();
+
+            auto& record = record_of(entity);
+
+            if (record.m_archetype == null) {
+                auto target = find_or_create(SigMapper::template map<Comp>());
+                auto row    = m_archetypes[target]->push(entity);
+                record      = { target, row };
+            } else {
+                auto& source = *m_archetypes[record.m_archetype];
+                assert(not source.has_column(comp_index) and "Component added to same entity more than once");
+
+                auto& edge = source.add_edge(comp_index);
+                if (edge == null) {
+                    edge = find_or_create(source.signature() | SigMapper::template map<Comp>());
+                }
+                move_entity(entity, record, edge);
+            }
+
+            auto& archetype = *m_archetypes[record.m_archetype];
+            archetype.write(comp_index, record.m_row, &component);
+
+            if constexpr (not concepts::Tag<Comp>) {
+                archetype.ticks(comp_index, record.m_row) = { tick, tick };
+            }
+        }
+
+        /**
+         * @brief Add components to many entities, the columns are indexed like the entities.
+         *
+         * Consecutive entities without any component are appended to the target archetype together and their
+         * components are copied chunk by chunk; the others are moved one by one.
+         */
+        template <util::OneOf<Comps...>... AddComps>
+        void add_components(Tick tick, std::span<const Entity> entities, std::span<const AddComps>... columns)
+        {
+            assert(((columns.size() == entities.size()) and ...) and "Every entity must have the components");
+
+            constexpr auto added = SigMapper::template map_multiple<AddComps...>();
+
+            for (auto i = 0uz; i < entities.size();) {
+                auto& record = record_of(entities[i]);
+
+                if (record.m_archetype != null) {
+                    auto current = m_archetypes[record.m_archetype]->signature();
+                    auto values  = std::array<const void*, sizeof...(Comps)>{};
+                    ((values[index_of<AddComps>()] = &columns[i]), ...);
+
+                    assert((current & added) == Signature{} and "Component added to same entity twice");
+                    set_components(entities[i], current, current | added, values, tick);
+
+                    ++i;
+                    continue;
+                }
+
+                auto target = find_or_create(added);
+                auto first  = i;
+                auto row    = m_archetypes[target]->size();
+
+                for (; i < entities.size() and record_of(entities[i]).m_archetype == null; ++i) {
+                    record_of(entities[i]) = { target, m_archetypes[target]->push(entities[i]) };
+                }
+
+                (copy_column(*m_archetypes[target], row, columns.subspan(first, i - first)), ...);
+                (fill_ticks<AddComps>(*m_archetypes[target], row, i - first, tick), ...);
+            }
+        }
+
+        template <util::OneOf<Comps...> Comp>
+        void remove_component(Entity entity)
+        {
+            constexpr auto comp_index = index_of<Comp>();
+
+            auto& record = record_of(entity);
+            assert(record.m_archetype != null and "Removing non-existent component");
+
+            auto& source = *m_archetypes[record.m_archetype];
+            assert(source.has_column(comp_index) and "Removing non-existent component");
+
+            auto signature = source.signature();
+            signature.reset(SigMapper::template map<Comp>());
+
+            // an entity without any component doesn't live in any archetype
+            if (signature == Signature{}) {
+                remove_row(record);
+                return;
+            }
+
+            auto& edge = source.remove_edge(comp_index);
+            if (edge == null) {
+                edge = find_or_create(signature);
+            }
+            move_entity(entity, record, edge);
+        }
+
+        // a reference, or a `SoaRef` proxy for components with a structure-of-arrays layout
+        template <util::OneOf<Comps...> Comp, typename Self>
+        decltype(auto) get_component(this Self&& self, Entity entity)
+        {
+            constexpr auto comp_index = index_of<Comp>();
+            constexpr auto is_const   = std::is_const_v<std::remove_reference_t<Self>>;
+
+            auto record = self.m_records[entity.index()];
+            assert(record.m_archetype != null and "Retrieving non-existent component");
+
+            auto& archetype = *self.m_archetypes[record.m_archetype];
+
+            if constexpr (concepts::Tag<Comp>) {
+                const Comp& tag = tag_instance<Comp>;
+                return tag;
+            } else if constexpr (concepts::SoaComponent<Comp>) {
+                using Ref = SoaRef<std::conditional_t<is_const, const Comp, Comp>>;
+
+                auto chunk = record.m_row / archetype.chunk_capacity();
+                auto slot  = record.m_row % archetype.chunk_capacity();
+                return Ref{ fields_at(archetype.template field_columns<Comp>(chunk), slot) };
+            } else {
+                auto* bytes = archetype.component_at(comp_index, record.m_row);
+                auto* comp  = std::launder(reinterpret_cast<Comp*>(bytes));
+
+                if constexpr (is_const) {
+                    return std::as_const(*comp);
+                } else {
+                    return *comp;
+                }
+            }
+        }
+
+        // like `get_component`, marking the component as changed at `tick`
+        template <util::OneOf<Comps...> Comp>
+        decltype(auto) get_component(Entity entity, Tick tick)
+        {
+            if constexpr (not concepts::Tag<Comp>) {
+                mark_changed<Comp>(entity, tick);
+            }
+            return get_component<Comp>(entity);
+        }
+
+        template <util::OneOf<Comps...> Comp>
+            requires (not concepts::Tag<Comp>)
+        ComponentTicks ticks(Entity entity) const
+        {
+            auto record = m_records[entity.index()];
+            assert(record.m_archetype != null and "Retrieving non-existent component");
+
+            return m_archetypes[record.m_archetype]->ticks(index_of<Comp>(), record.m_row);
+        }
+
+        template <util::OneOf<Comps...> Comp>
+            requires (not concepts::Tag<Comp>)
+        void mark_changed(Entity entity, Tick tick)
+        {
+            auto record = m_records[entity.index()];
+            assert(record.m_archetype != null and "Marking non-existent component");
+
+            m_archetypes[record.m_archetype]->ticks(index_of<Comp>(), record.m_row).m_changed = tick;
+        }
+
+        /**
+         * @brief Change the components of an entity from one signature to another at once.
+         *
+         * The entity's row is moved at most once, directly into the archetype of the target signature.
+         *
+         * @param current The signature of the entity's current components.
+         * @param target The signature of the components the entity should end up with.
+         * @param values Indexed by component, pointers to the values of the components to write. Must be
+         * non-null for components in `target` but not in `current`, others are kept if null.
+         * @param tick The tick the written components are marked as added or changed at.
+         */
+        void set_components(
+            Entity                        entity,
+            Signature                     current,
+            Signature                     target,
+            std::span<const void* const> values,
+            Tick                          tick
+        )
+        {
+            assert(values.size() == sizeof...(Comps) and "Values must be indexed by component");
+
+            auto& record = record_of(entity);
+            assert(
+                (record.m_archetype == null ? Signature{} : m_archetypes[record.m_archetype]->signature())
+                    == current
+                and "Current signature doesn't match the stored components"
+            );
+
+            if (target == Signature{}) {
+                if (record.m_archetype != null) {
+                    remove_row(record);
+                }
+                return;
+            }
+
+            auto dest = find_or_create(target);
+            if (record.m_archetype == null) {
+                record = { dest, m_archetypes[dest]->push(entity) };
+            } else if (record.m_archetype != dest) {
+                move_entity(entity, record, dest);
+            }
+
+            auto added = target & ~current;
+
+            auto& archetype = *m_archetypes[dest];
+            for (auto i = 0uz; i < sizeof...(Comps); ++i) {
+                auto bit = Signature{ Signature::Inner{ 1 } << i };
+                assert((values[i] != nullptr or not added.test(bit)) and "Added component must have a value");
+
+                if (values[i] == nullptr or not archetype.has_column(i)) {
+                    continue;
+                }
+
+                archetype.write(i, record.m_row, values[i]);
+
+                if (not archetype.has_ticks(i)) {
+                    continue;
+                }
+
+                auto& ticks = archetype.ticks(i, record.m_row);
+                if (added.test(bit)) {
+                    ticks = { tick, tick };
+                } else {
+                    ticks.m_changed = tick;
+                }
+            }
+        }
+
+        void entity_destroyed(Entity entity)
+        {
+            // an entity that never had a component may not have a record yet
+            if (entity.index() >= m_records.capacity()) {
+                return;
+            }
+
+            auto& record = m_records[entity.index()];
+            if (record.m_archetype != null) {
+                remove_row(record);
+            }
+        }
+
+        /**
+         * @brief A position among the entities that have all the given components, see `for_each_in`.
+         *
+         * Goes through the rows of the archetypes that have the components, in order.
+         */
+        template <util::OneOf<Comps...>... Qs>
+        class Cursor
+        {
+        public:
+            Cursor() = default;
+
+            Cursor(ArchetypeManager& manager, std::size_t position)
+                : m_manager{ &manager }
+                , m_position{ position }
+                , m_row{ position }
+            {
+                seek();
+            }
+
+            std::size_t position() const { return m_position; }
+            Entity      entity() const { return archetype().entity_at(m_row); }
+
+            std::tuple<ComponentSlot<Qs>...> slots() const
+            {
+                auto& archetype = this->archetype();
+                auto  chunk     = m_row / archetype.chunk_capacity();
+                auto  slot      = m_row % archetype.chunk_capacity();
+                return { slot_at<Qs>(chunk_columns<Qs>(archetype, chunk), slot)... };
+            }
+
+            void advance()
+            {
+                ++m_position;
+                ++m_row;
+                seek();
+            }
+
+        private:
+            static constexpr auto query = SignatureMapper<Comps...>::template map_multiple<Qs...>();
+
+            Archetype& archetype() const { return *m_manager->m_archetypes[m_archetype]; }
+
+            // move on to the archetype that has the row, the row is then relative to that archetype
+            void seek()
+            {
+                const auto& archetypes = m_manager->m_archetypes;
+
+                for (; m_archetype < archetypes.size(); ++m_archetype) {
+                    const auto& current = *archetypes[m_archetype];
+                    if (not current.signature().test(query)) {
+                        continue;
+                    }
+                    if (m_row < current.size()) {
+                        break;
+                    }
+                    m_row -= current.size();
+                }
+            }
+
+            ArchetypeManager* m_manager   = nullptr;
+            std::size_t       m_position  = 0;
+            std::size_t       m_archetype = 0;
+            std::size_t       m_row       = 0;
+        };
+
+        template <util::OneOf<Comps...>... Qs>
+        Cursor<Qs...> cursor(const SparseSet& matched, std::size_t position)
+        {
+            assert(position <= matched.size() and "Position past the matched entities");
+            return { *this, position };
+        }
+
+        /**
+         * @brief Iterate over part of the entities that have all the given components, chunk by chunk.
+         *
+         * The entities are walked in the order of the archetypes' rows, which is not the order of `matched`,
+         * so the columns of a chunk are read front to back and each component is found without a lookup.
+         *
+         * @param matched The entities that have the components, as cached by the coordinator.
+         * @param begin The position of the first entity to visit in that order.
+         * @param end The position past the last one, at most the size of `matched`.
+         * @param fn Invoked as `fn(entity, slots...)` with a `ComponentSlot` for each of the components.
+         */
+        template <util::OneOf<Comps...>... Qs, typename Fn>
+        void for_each_in(const SparseSet& matched, std::size_t begin, std::size_t end, Fn&& fn)
+        {
+            constexpr auto query = SigMapper::template map_multiple<Qs...>();
+
+            assert(end <= matched.size() and "Iterating past the matched entities");
+
+            // the position of the archetype's first row among the entities that have the components
+            auto offset = 0uz;
+
+            for (auto& archetype : m_archetypes) {
+                if (offset >= end) {
+                    break;
+                }
+                if (not archetype->signature().test(query)) {
+                    continue;
+                }
+
+                auto size  = archetype->size();
+                auto first = std::max(begin, offset) - offset;
+                auto last  = std::min(end, offset + size) - offset;
+                offset    += size;
+
+                auto capacity = archetype->chunk_capacity();
+                for (auto row = first; row < last;) {
+                    auto chunk = row / capacity;
+                    auto slot  = row % capacity;
+                    auto count = std::min(capacity - slot, last - row);
+
+                    auto* entities = archetype->entities(chunk);
+                    auto  invoke   = [&](auto... columns) {
+                        for (auto i = slot; i < slot + count; ++i) {
+                            fn(entities[i], slot_at<Qs>(columns, i)...);
+                        }
+                    };
+                    invoke(chunk_columns<Qs>(*archetype, chunk)...);
+
+                    row += count;
+                }
+            }
+        }
+
+        // mark every component as added at `tick`, e.g. after loading a snapshot
+        void reset_ticks(Tick tick)
+        {
+            for (auto& archetype : m_archetypes) {
+                archetype->reset_ticks(tick);
+            }
+        }
+
+        std::size_t archetype_count() const { return m_archetypes.size(); }
+
+        static constexpr SnapshotStorage snapshot_storage = SnapshotStorage::Archetype;
+
+        // the signature and rows of every archetype, then the records of the entities
+        void save(SnapshotWriter& writer) const
+        {
+            writer.write(static_cast<std::uint64_t>(m_archetypes.size()));
+            for (const auto& archetype : m_archetypes) {
+                writer.write(archetype->signature());
+                archetype->save(writer);
+            }
+            writer.write_paged(m_records, m_records.capacity());
+        }
+
+        // replace the archetypes with the ones saved, false if the snapshot is corrupted
+        bool load(SnapshotReader& reader)
+        {
+            constexpr auto all = SigMapper::template map_multiple<Comps...>();
+
+            m_archetypes.clear();
+            m_lookup.clear();
+
+            auto count = reader.read<std::uint64_t>();
+            for (auto index = 0uz; index < count and reader.ok(); ++index) {
+                auto signature = reader.read<Signature>();
+                auto known     = signature != Signature{} and (signature & ~all) == Signature{};
+                if (not known or m_lookup.contains(signature)) {
+                    return false;
+                }
+
+                m_archetypes.push_back(std::make_unique<Archetype>(signature));
+                m_lookup.emplace(signature, index);
+
+                if (not m_archetypes.back()->load(reader)) {
+                    return false;
+                }
+            }
+
+            reader.adopt(m_records);
+            return reader.ok();
+        }
+
+    private:
+        using SigMapper = SignatureMapper<Comps...>;
+
+        static constexpr std::size_t null = Archetype::npos;
+
+        // location of an entity's components, `m_archetype` is null if the entity has no component
+        struct Record
+        {
+            std::size_t m_archetype = null;
+            std::size_t m_row       = 0;
+        };
+
+        // the record of an entity, growing the records to the entity's index if needed
+        Record& record_of(Entity entity)
+        {
+            m_records.reserve(entity.index() + 1);
+            return m_records[entity.index()];
+        }
+
+        template <util::OneOf<Comps...> Comp>
+        static constexpr std::size_t index_of()
+        {
+            return util::PackTraits<Comps...>::template index<Comp>();
+        }
+
+        // the column of a component in a chunk, all rows of a tag share its single instance, and a component
+        // with a structure-of-arrays layout is referred to by a proxy of the chunk's first row
+        template <util::OneOf<Comps...> Comp>
+        static auto column_of(Archetype& archetype, std::size_t chunk)
+        {
+            if constexpr (concepts::Tag<Comp>) {
+                return &tag_instance<Comp>;
+            } else if constexpr (concepts::SoaComponent<Comp>) {
+                return SoaRef<Comp>{ archetype.template field_columns<Comp>(chunk) };
+            } else {
+                return archetype.template column<Comp>(chunk);
+            }
+        }
+
+        // the column of a component in a chunk along with the ticks of the chunk's rows, tags have none
+        template <util::OneOf<Comps...> Comp>
+        static auto chunk_columns(Archetype& archetype, std::size_t chunk)
+        {
+            if constexpr (concepts::Tag<Comp>) {
+                return std::pair{ column_of<Comp>(archetype, chunk), nullptr };
+            } else {
+                auto* ticks = &archetype.ticks(index_of<Comp>(), chunk * archetype.chunk_capacity());
+                return std::pair{ column_of<Comp>(archetype, chunk), ticks };
+            }
+        }
+
+        // a component of a row and its ticks, given the columns of the row's chunk
+        template <util::OneOf<Comps...> Comp, typename Column, typename Ticks>
+        static ComponentSlot<Comp> slot_at(const std::pair<Column, Ticks>& columns, std::size_t row)
+        {
+            if constexpr (concepts::Tag<Comp>) {
+                return { element_at(columns.first, row), nullptr };
+            } else {
+                return { element_at(columns.first, row), columns.second + row };
+            }
+        }
+
+        template <typename Comp>
+        static Comp& element_at(Comp* column, std::size_t row)
+        {
+            if constexpr (concepts::Tag<std::remove_const_t<Comp>>) {
+                return *column;
+            } else {
+                return column[row];
+            }
+        }
+
+        template <typename Comp>
+        static SoaRef<Comp> element_at(const SoaRef<Comp>& column, std::size_t row)
+        {
+            return SoaRef<Comp>{ fields_at(column.fields(), row) };
+        }
+
+        // pointers to the fields of a row, given the field columns of its chunk
+        template <typename... Fields>
+        static std::tuple<Fields*...> fields_at(std::tuple<Fields*...> columns, std::size_t slot)
+        {
+            return std::apply([&](Fields*... column) { return std::tuple{ column + slot... }; }, columns);
+        }
+
+        // copy components into consecutive rows of an archetype, a chunk at a time
+        template <util::OneOf<Comps...> Comp>
+        static void copy_column(Archetype& archetype, std::size_t first_row, std::span<const Comp> values)
+        {
+            // tags have no column to copy into, the fields of the others are scattered one row at a time
+            if constexpr (concepts::SoaComponent<Comp>) {
+                for (auto i = 0uz; i < values.size(); ++i) {
+                    archetype.write(index_of<Comp>(), first_row + i, &values[i]);
+                }
+            } else if constexpr (not concepts::Tag<Comp>) {
+                auto capacity = archetype.chunk_capacity();
+
+                for (auto done = 0uz; done < values.size();) {
+                    auto row   = first_row + done;
+                    auto slot  = row % capacity;
+                    auto count = std::min(capacity - slot, values.size() - done);
+
+                    auto* column = archetype.template column<Comp>(row / capacity);
+                    std::memcpy(column + slot, values.data() + done, count * sizeof(Comp));
+
+                    done += count;
+                }
+            }
+        }
+
+        // mark the components of consecutive rows of an archetype as added at `tick`
+        template <util::OneOf<Comps...> Comp>
+        static void fill_ticks(Archetype& archetype, std::size_t first_row, std::size_t count, Tick tick)
+        {
+            if constexpr (not concepts::Tag<Comp>) {
+                for (auto row = first_row; row < first_row + count; ++row) {
+                    archetype.ticks(index_of<Comp>(), row) = { tick, tick };
+                }
+            }
+        }
+
+        std::size_t find_or_create(Signature signature)
+        {
+            if (auto found = m_lookup.find(signature); found != m_lookup.end()) {
+                return found->second;
+            }
+
+            auto index = m_archetypes.size();
+            m_archetypes.push_back(std::make_unique<Archetype>(signature));
+            m_lookup.emplace(signature, index);
+
+            return index;
+        }
+
+        // move the row of an entity into another archetype, copying the components both archetypes share
+        void move_entity(Entity entity, Record& record, std::size_t target)
+        {
+            auto& source = *m_archetypes[record.m_archetype];
+            auto& dest   = *m_archetypes[target];
+            auto  row    = dest.push(entity);
+
+            for (auto i = 0uz; i < sizeof...(Comps); ++i) {
+                if (source.has_column(i) and dest.has_column(i)) {
+                    source.copy_to(i, record.m_row, dest, row);
+                }
+            }
+
+            remove_row(record);
+            record = { target, row };
+        }
+
+        void remove_row(Record& record)
+        {
+            auto& archetype = *m_archetypes[record.m_archetype];
+
+            // the last row of the archetype is moved into the removed row's place
+            if (auto moved = archetype.swap_remove(record.m_row)) {
+                m_records[moved->index()].m_row = record.m_row;
+            }
+
+            record = {};
+        }
+
+        std::vector<std::unique_ptr<Archetype>>    m_archetypes;
+        std::unordered_map<Signature, std::size_t> m_lookup;
+
+        util::PagedArray<Record, config::sparse_page_size> m_records;
+    };
+}
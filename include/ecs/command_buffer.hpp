@@ -0,0 +1,302 @@
+#pragma once
+
+#include "ecs/common.hpp"
+#include "ecs/concepts.hpp"
+#include "ecs/profiler.hpp"
+#include "ecs/util/concepts.hpp"
+#include "ecs/util/meta.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace ecs
+{
+    /**
+     * @brief The net effect of a batch of structural changes, per entity.
+     *
+     * Each entity touched by the batch appears once, with the components it gains (or whose value is
+     * replaced) and the components it loses, regardless of how many operations touched it.
+     */
+    template <concepts::Component... Comps>
+    class ChangeSet
+    {
+    public:
+        struct Change
+        {
+            Entity    m_entity;
+            Signature m_added     = {};
+            Signature m_removed   = {};
+            bool      m_destroyed = false;
+
+            // indexed by component, the value of each added component
+            std::array<const void*, sizeof...(Comps)> m_values = {};
+        };
+
+        // get the change of an entity, starting an empty one if the entity wasn't touched yet
+        Change& get(Entity entity)
+        {
+            auto [found, inserted] = m_lookup.try_emplace(entity.m_inner, m_changes.size());
+            if (inserted) {
+                m_changes.push_back({ .m_entity = entity });
+            }
+            return m_changes[found->second];
+        }
+
+        std::span<const Change> changes() const { return m_changes; }
+
+        bool empty() const { return m_changes.empty(); }
+
+        void clear()
+        {
+            m_changes.clear();
+            m_lookup.clear();
+        }
+
+    private:
+        std::vector<Change>                            m_changes;
+        std::unordered_map<Entity::Inner, std::size_t> m_lookup;
+    };
+
+    /**
+     * @brief Records structural changes to be applied later, at once.
+     *
+     * Creating and destroying entities and adding or removing components while iterating over entities
+     * invalidates the iteration, and doing it one operation at a time updates the signatures and queries
+     * repeatedly. A command buffer records these operations instead; the coordinator applies them at a sync
+     * point, coalesced per entity.
+     *
+     * A buffer is not thread-safe, each thread records into its own (see `CommandBuffers`).
+     */
+    template <concepts::Component... Comps>
+        requires util::Unique<Comps...>
+    class CommandBuffer
+    {
+    public:
+        using ChangeSet = ecs::ChangeSet<Comps...>;
+
+        // an entity that will be created when the buffer is applied, only meaningful to the same buffer
+        struct PendingEntity
+        {
+            std::uint32_t m_index;
+        };
+
+        CommandBuffer() = default;
+
+        PendingEntity create_entity()
+        {
+            auto pending = PendingEntity{ m_pending_count++ };
+            record({ Kind::Create, 0, Target{ pending } });
+            return pending;
+        }
+
+        void destroy_entity(Entity entity) { record({ Kind::Destroy, 0, Target{ entity } }); }
+
+        // adding a component the entity already has replaces its value
+        template <util::OneOf<Comps...> Comp>
+        void add_component(Entity entity, Comp component)
+        {
+            record_add(Target{ entity }, component);
+        }
+
+        template <util::OneOf<Comps...> Comp>
+        void add_component(PendingEntity entity, Comp component)
+        {
+            record_add(Target{ entity }, component);
+        }
+
+        template <util::OneOf<Comps...> Comp>
+        void remove_component(Entity entity)
+        {
+            record({ Kind::Remove, index_of<Comp>(), Target{ entity } });
+        }
+
+        template <util::OneOf<Comps...> Comp>
+        void remove_component(PendingEntity entity)
+        {
+            record({ Kind::Remove, index_of<Comp>(), Target{ entity } });
+        }
+
+        bool        empty() const { return m_commands.empty(); }
+        std::size_t size() const { return m_commands.size(); }
+
+        void clear()
+        {
+            m_commands.clear();
+            std::apply([](auto&... values) { (values.clear(), ...); }, m_values);
+            m_pending_count = 0;
+        }
+
+        /**
+         * @brief Fold the recorded commands into a change set, in recording order.
+         *
+         * The values in the change set point into this buffer, so it must not be modified until the changes
+         * are applied. Commands on an entity destroyed by an earlier command, from this buffer or one folded
+         * before it, are skipped.
+         *
+         * @param changes The change set to fold into.
+         * @param create Invoked to create each pending entity, must return the created entity.
+         */
+        template <std::invocable Create>
+            requires std::same_as<std::invoke_result_t<Create&>, Entity>
+        void collect(ChangeSet& changes, Create&& create) const
+        {
+            auto created = std::vector<Entity>{};
+            created.reserve(m_pending_count);
+
+            // the value columns, type-erased so they can be indexed by the component index of a command
+            auto column = [&]<typename Comp>() {
+                return reinterpret_cast<const std::byte*>(std::get<std::vector<Comp>>(m_values).data());
+            };
+            auto columns = std::array{ column.template operator()<Comps>()... };
+            auto sizes   = std::array{ sizeof(Comps)... };
+
+            auto value_at = [&](std::size_t component, std::uint32_t value) -> const void* {
+                return columns[component] + value * sizes[component];
+            };
+            auto resolve = [&](Target target) {
+                return target.m_pending ? created[target.m_id] : Entity{ target.m_id };
+            };
+
+            for (const auto& command : m_commands) {
+                if (command.m_kind == Kind::Create) {
+                    created.push_back(create());
+                    continue;
+                }
+
+                auto& change = changes.get(resolve(command.m_target));
+                auto  bit    = Signature{ Signature::Inner{ 1 } << command.m_component };
+
+                // destroyed by an earlier command, possibly from another thread's buffer
+                if (change.m_destroyed) {
+                    continue;
+                }
+
+                switch (command.m_kind) {
+                case Kind::Destroy: change.m_destroyed = true; break;
+                case Kind::Add:
+                    change.m_added.set(bit);
+                    change.m_removed.reset(bit);
+                    change.m_values[command.m_component] = value_at(command.m_component, command.m_value);
+                    break;
+                case Kind::Remove:
+                    change.m_added.reset(bit);
+                    change.m_removed.set(bit);
+                    change.m_values[command.m_component] = nullptr;
+                    break;
+                case Kind::Create: break;
+                }
+            }
+        }
+
+    private:
+        enum class Kind : std::uint8_t
+        {
+            Create,
+            Destroy,
+            Add,
+            Remove,
+        };
+
+        // either an existing entity or the index of a pending one
+        struct Target
+        {
+            Target(Entity entity)
+                : m_id{ entity.m_inner }
+                , m_pending{ false }
+            {
+            }
+
+            Target(PendingEntity entity)
+                : m_id{ entity.m_index }
+                , m_pending{ true }
+            {
+            }
+
+            Entity::Inner m_id;
+            bool          m_pending;
+        };
+
+        struct Command
+        {
+            Kind          m_kind;
+            std::uint8_t  m_component;
+            Target        m_target;
+            std::uint32_t m_value = 0;    // index into the component's value column
+        };
+
+        template <util::OneOf<Comps...> Comp>
+        static constexpr std::uint8_t index_of()
+        {
+            return static_cast<std::uint8_t>(util::PackTraits<Comps...>::template index<Comp>());
+        }
+
+        template <util::OneOf<Comps...> Comp>
+        void record_add(Target target, Comp component)
+        {
+            auto& values = std::get<std::vector<Comp>>(m_values);
+            auto  value  = static_cast<std::uint32_t>(values.size());
+
+            values.push_back(component);
+            record({ Kind::Add, index_of<Comp>(), target, value });
+        }
+
+        void record(const Command& command)
+        {
+            m_commands.push_back(command);
+            Profiler::count_structural_changes();
+        }
+
+        std::vector<Command>              m_commands;
+        std::tuple<std::vector<Comps>...> m_values;
+        std::uint32_t                     m_pending_count = 0;
+    };
+
+    /**
+     * @brief A command buffer per recording thread.
+     *
+     * Getting the buffer of the current thread takes a lock, so a task should get it once rather than for
+     * every command. References to the buffers stay valid for the lifetime of this object.
+     */
+    template <concepts::Component... Comps>
+    class CommandBuffers
+    {
+    public:
+        using CommandBuffer = ecs::CommandBuffer<Comps...>;
+
+        CommandBuffers() = default;
+
+        CommandBuffer& local()
+        {
+            auto lock = std::scoped_lock{ m_mutex };
+
+            auto& buffer = m_lookup[std::this_thread::get_id()];
+            if (buffer == nullptr) {
+                buffer = m_buffers.emplace_back(std::make_unique<CommandBuffer>()).get();
+            }
+            return *buffer;
+        }
+
+        // invoke a function for each buffer, in the order the threads first recorded; not thread-safe
+        template <std::invocable<CommandBuffer&> Fn>
+        void for_each(Fn&& fn)
+        {
+            for (auto& buffer : m_buffers) {
+                fn(*buffer);
+            }
+        }
+
+    private:
+        std::vector<std::unique_ptr<CommandBuffer>>         m_buffers;
+        std::unordered_map<std::thread::id, CommandBuffer*> m_lookup;
+        std::mutex                                          m_mutex;
+    };
+}
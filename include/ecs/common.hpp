@@ -4,21 +4,44 @@
 
 #include <chrono>
 #include <compare>
+#include <cstdint>
 #include <functional>
 
 namespace ecs
 {
+    /**
+     * @brief Handle to an entity.
+     *
+     * The low bits are the index of the entity's slot, the high bits are the generation of the slot: the
+     * number of times it was reused, wrapping around. A handle to a destroyed entity doesn't compare equal to
+     * the handle of an entity that reuses its slot (until the generation wraps around).
+     */
     struct Entity
     {
         using Inner = config::EntityInner;
 
+        static constexpr std::size_t index_bits      = config::entity_index_bits;
+        static constexpr std::size_t generation_bits = sizeof(Inner) * 8 - index_bits;
+        static constexpr Inner       index_mask      = (Inner{ 1 } << index_bits) - 1;
+        static constexpr Inner       generation_mask = (Inner{ 1 } << generation_bits) - 1;
+
+        static_assert(config::max_entities <= index_mask, "Entity index bits can't address every entity");
+
         constexpr explicit Entity(Inner inner)
             : m_inner{ inner }
         {
         }
 
+        static constexpr Entity make(Inner index, Inner generation)
+        {
+            return Entity{ ((generation & generation_mask) << index_bits) | (index & index_mask) };
+        }
+
         std::strong_ordering operator<=>(Entity const&) const = default;
 
+        constexpr Inner index() const { return m_inner & index_mask; }
+        constexpr Inner generation() const { return m_inner >> index_bits; }
+
         Inner m_inner = 0;
     };
 
@@ -69,6 +92,31 @@ namespace ecs
         Inner m_inner = 0;
     };
 
+    /**
+     * @brief A point in the sequence of changes made to the components of a coordinator.
+     *
+     * The coordinator advances its tick every time a system finishes running. Components record the tick
+     * they were added at and the tick they were last accessed mutably at, so a system can tell which of them
+     * changed since its previous run. Ticks wrap around and are compared by their difference, so a component
+     * left untouched for 2^31 system runs is seen as changed again.
+     */
+    using Tick = std::uint32_t;
+
+    // whether `tick` comes after `since`, accounting for wrapping around
+    constexpr bool is_newer(Tick tick, Tick since)
+    {
+        return static_cast<std::int32_t>(tick - since) > 0;
+    }
+
+    struct ComponentTicks
+    {
+        Tick m_added   = 0;
+        Tick m_changed = 0;    // also set when added
+
+        constexpr bool added_since(Tick since) const { return is_newer(m_added, since); }
+        constexpr bool changed_since(Tick since) const { return is_newer(m_changed, since); }
+    };
+
     using Clock     = std::chrono::steady_clock;
     using TimePoint = Clock::time_point;
     using Duration  = std::chrono::duration<float>;
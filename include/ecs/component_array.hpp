@@ -3,85 +3,443 @@
 #include "ecs/common.hpp"
 #include "ecs/concepts.hpp"
 #include "ecs/config.hpp"
-#include "ecs/util/fixed_array.hpp"
+#include "ecs/snapshot.hpp"
+#include "ecs/soa.hpp"
+#include "ecs/sparse_set.hpp"
+#include "ecs/tag.hpp"
+#include "ecs/util/paged_array.hpp"
 
+#include <algorithm>
 #include <cassert>
-#include <unordered_map>
+#include <cstring>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace ecs
 {
+    /**
+     * @brief Densely packed components of a single type, grown a page at a time.
+     *
+     * Nothing is allocated until the first component is inserted, so component types that only a few entities
+     * have stay cheap. Each component has its `ComponentTicks` next to it, in an array indexed the same way.
+     */
     template <concepts::Component Comp>
     class ComponentArray
     {
     public:
         using Component = Comp;
 
-        void insert_data(Entity entity, Component component)
-        {
-            assert(
-                not m_entity_to_index.contains(entity) and "Component added to same entity more than once"
-            );
+        ComponentArray() = default;
 
-            auto index = m_size;
+        explicit ComponentArray(std::size_t capacity) { reserve(capacity); }
 
-            // update maps
-            m_entity_to_index.emplace(entity, index);
-            m_index_to_entity.emplace(index, entity);
+        void insert_data(Entity entity, Component component, Tick tick)
+        {
+            assert(not m_entities.contains(entity) and "Component added to same entity more than once");
 
             // put new entry at end
+            auto index = m_entities.insert(entity);
+            m_components.reserve(index + 1);
+            m_ticks.reserve(index + 1);
             m_components[index] = component;
-
-            ++m_size;
+            m_ticks[index]      = { tick, tick };
         }
 
-        void remove_data(Entity entity)
+        /**
+         * @brief Insert the components of many entities at once.
+         *
+         * The entities are appended to the dense array together, so their components are copied as a single
+         * contiguous block.
+         */
+        void insert_bulk(std::span<const Entity> entities, std::span<const Component> components, Tick tick)
         {
-            assert(m_entity_to_index.contains(entity) and "Removing non-existent component");
+            assert(entities.size() == components.size() and "Every entity must have a component");
 
-            // copy element at end into deleted element's place to maintain density
-            auto index_of_removed_entity = m_entity_to_index[entity];
-            auto index_of_last_element   = m_size - 1;
+            auto first = m_entities.size();
+            reserve(first + entities.size());
 
-            m_components[index_of_removed_entity] = m_components[index_of_last_element];
+            for (auto entity : entities) {
+                assert(not m_entities.contains(entity) and "Component added to same entity more than once");
+                m_entities.insert(entity);
+            }
 
-            // update map to point to moved spot
-            auto last_entity = m_index_to_entity[index_of_last_element];
+            // a block per page
+            for (auto done = 0uz; done < components.size();) {
+                auto run = m_components.run(first + done, components.size() - done);
+                std::memcpy(run.data(), components.data() + done, run.size_bytes());
+                std::ranges::fill(m_ticks.run(first + done, run.size()), ComponentTicks{ tick, tick });
+                done += run.size();
+            }
+        }
 
-            m_entity_to_index[last_entity]             = index_of_removed_entity;
-            m_index_to_entity[index_of_removed_entity] = last_entity;
+        void remove_data(Entity entity)
+        {
+            assert(m_entities.contains(entity) and "Removing non-existent component");
 
-            m_entity_to_index.erase(entity);
-            m_index_to_entity.erase(index_of_last_element);
+            // the set moves its last entity into the removed entity's place, do the same for the component
+            auto index_of_removed_entity = m_entities.remove(entity);
+            auto index_of_last_element   = m_entities.size();
 
-            --m_size;
+            m_components[index_of_removed_entity] = m_components[index_of_last_element];
+            m_ticks[index_of_removed_entity]      = m_ticks[index_of_last_element];
         }
 
+        // the component without marking it as changed, even through a mutable reference
         template <typename Self>
         auto&& get_data(this Self&& self, Entity entity)
         {
-            assert(self.m_entity_to_index.contains(entity) and "Retrieving non-existent component");
+            assert(self.m_entities.contains(entity) and "Retrieving non-existent component");
 
             // return a reference to the entity's component
-            auto index = self.m_entity_to_index.at(entity);
+            auto index = self.m_entities.index_of(entity);
             return std::forward<decltype(self)>(self).m_components[index];
         }
 
+        // the component to write to, marking it as changed at `tick`
+        Component& get_data(Entity entity, Tick tick)
+        {
+            assert(m_entities.contains(entity) and "Retrieving non-existent component");
+
+            auto index               = m_entities.index_of(entity);
+            m_ticks[index].m_changed = tick;
+            return m_components[index];
+        }
+
+        ComponentTicks ticks(Entity entity) const
+        {
+            assert(m_entities.contains(entity) and "Retrieving non-existent component");
+            return m_ticks[m_entities.index_of(entity)];
+        }
+
+        void mark_changed(Entity entity, Tick tick)
+        {
+            assert(m_entities.contains(entity) and "Marking non-existent component");
+            m_ticks[m_entities.index_of(entity)].m_changed = tick;
+        }
+
+        bool contains(Entity entity) const { return m_entities.contains(entity); }
+
         void entity_destroyed(Entity entity)
         {
-            if (m_entity_to_index.contains(entity)) {
+            if (m_entities.contains(entity)) {
                 remove_data(entity);
             }
         }
 
+        std::size_t size() const { return m_entities.size(); }
+
+        // the entities in the order of the dense array, an entity is at its `index_of` there
+        std::span<const Entity> entities() const { return m_entities.entities(); }
+
+        std::size_t index_of(Entity entity) const
+        {
+            assert(m_entities.contains(entity) and "Retrieving non-existent component");
+            return m_entities.index_of(entity);
+        }
+
+        ComponentTicks& ticks_at(std::size_t index) { return m_ticks[index]; }
+
+        // mark every component as added at `tick`
+        void reset_ticks(Tick tick)
+        {
+            for (auto done = 0uz; done < size();) {
+                auto run = m_ticks.run(done, size() - done);
+                std::ranges::fill(run, ComponentTicks{ tick, tick });
+                done += run.size();
+            }
+        }
+
+        // the component at an index of the dense array, without marking it as changed
+        Component& at(std::size_t index) { return m_components[index]; }
+
+        void reserve(std::size_t capacity)
+        {
+            m_entities.reserve(capacity);
+            m_components.reserve(capacity);
+            m_ticks.reserve(capacity);
+        }
+
+        // release the memory not needed by the current components, e.g. after destroying many entities
+        void shrink_to_fit()
+        {
+            m_entities.shrink_to_fit();
+            m_components.shrink(m_entities.size());
+            m_ticks.shrink(m_entities.size());
+        }
+
+        void save(SnapshotWriter& writer) const
+        {
+            m_entities.save(writer);
+            writer.write_paged(m_components, size());
+            writer.write_paged(m_ticks, size());
+        }
+
+        // replace the components with the ones saved, using the pages of the snapshot in place
+        bool load(SnapshotReader& reader)
+        {
+            auto loaded = m_entities.load(reader);
+            reader.adopt(m_components);
+            reader.adopt(m_ticks);
+
+            // every entity must have its component within the pages
+            auto covered = m_components.capacity() >= size() and m_ticks.capacity() >= size();
+            return loaded and reader.ok() and covered;
+        }
+
     private:
         // entities array
-        util::FixedArray<Comp, config::max_entities> m_components = {};
+        util::PagedArray<Comp, config::component_page_size> m_components;
+
+        // indexed like the components, kept apart so that iterating the components doesn't read them
+        util::PagedArray<ComponentTicks, config::component_page_size> m_ticks;
+
+        // entities that have this component, position in the set is the index to the array
+        SparseSet m_entities;
+    };
+
+    /**
+     * @brief Tags are only represented by the signature bits of the entities, so their array stores nothing.
+     *
+     * Whether an entity has the tag is answered by its signature, retrieving it yields `tag_instance`. With
+     * no value to change, tags have no ticks either.
+     */
+    template <concepts::Tag Comp>
+    class ComponentArray<Comp>
+    {
+    public:
+        using Component = Comp;
+
+        ComponentArray() = default;
+
+        explicit ComponentArray(std::size_t /* capacity */) {}
+
+        void insert_data(Entity, Component, Tick) {}
+        void insert_bulk(std::span<const Entity>, std::span<const Component>, Tick) {}
+        void remove_data(Entity) {}
+
+        const Component& get_data(Entity) const { return tag_instance<Component>; }
+        const Component& get_data(Entity, Tick) const { return tag_instance<Component>; }
+
+        void entity_destroyed(Entity) {}
+        void reserve(std::size_t) {}
+        void shrink_to_fit() {}
+        void reset_ticks(Tick) {}
+
+        // the signatures alone tell which entities have the tag
+        void save(SnapshotWriter&) const {}
+        bool load(SnapshotReader&) { return true; }
+    };
+
+    /**
+     * @brief Components with a structure-of-arrays layout keep each field in its own paged column.
+     *
+     * The columns share the order of the entity set, so the fields of a component are at the same index in
+     * every column, and so are their ticks. Components are yielded as `SoaRef` proxies.
+     */
+    template <concepts::SoaComponent Comp>
+    class ComponentArray<Comp>
+    {
+    public:
+        using Component = Comp;
+        using Layout    = SoaLayout<Comp>;
+
+        static_assert(detail::lists_every_member<Layout>());
+
+        ComponentArray() = default;
+
+        explicit ComponentArray(std::size_t capacity) { reserve(capacity); }
+
+        void insert_data(Entity entity, Component component, Tick tick)
+        {
+            assert(not m_entities.contains(entity) and "Component added to same entity more than once");
+
+            // put new entry at end
+            auto index = m_entities.insert(entity);
+            reserve_columns(index + 1);
+            store(index, component);
+            m_ticks[index] = { tick, tick };
+        }
+
+        void insert_bulk(std::span<const Entity> entities, std::span<const Component> components, Tick tick)
+        {
+            assert(entities.size() == components.size() and "Every entity must have a component");
+
+            reserve(m_entities.size() + entities.size());
+
+            for (auto i = 0uz; i < entities.size(); ++i) {
+                assert(not m_entities.contains(entities[i]) and "Component added to same entity twice");
+
+                auto index = m_entities.insert(entities[i]);
+                store(index, components[i]);
+                m_ticks[index] = { tick, tick };
+            }
+        }
+
+        void remove_data(Entity entity)
+        {
+            assert(m_entities.contains(entity) and "Removing non-existent component");
+
+            // the set moves its last entity into the removed entity's place, do the same for every field
+            auto index_of_removed_entity = m_entities.remove(entity);
+            auto index_of_last_element   = m_entities.size();
+
+            std::apply(
+                [&](auto&... columns) {
+                    ((columns[index_of_removed_entity] = columns[index_of_last_element]), ...);
+                },
+                m_columns
+            );
+            m_ticks[index_of_removed_entity] = m_ticks[index_of_last_element];
+        }
+
+        // the component without marking it as changed, even through a mutable proxy
+        template <typename Self>
+        auto get_data(this Self&& self, Entity entity)
+        {
+            assert(self.m_entities.contains(entity) and "Retrieving non-existent component");
+
+            constexpr auto is_const = std::is_const_v<std::remove_reference_t<Self>>;
+            using Ref               = SoaRef<std::conditional_t<is_const, const Comp, Comp>>;
+
+            auto index = self.m_entities.index_of(entity);
+            return std::apply(
+                [&](auto&... columns) { return Ref{ typename Ref::Pointers{ &columns[index]... } }; },
+                self.m_columns
+            );
+        }
+
+        // the component to write to, marking it as changed at `tick`
+        SoaRef<Comp> get_data(Entity entity, Tick tick)
+        {
+            assert(m_entities.contains(entity) and "Retrieving non-existent component");
+
+            auto index               = m_entities.index_of(entity);
+            m_ticks[index].m_changed = tick;
+            using Ref = SoaRef<Comp>;
+            return std::apply(
+                [&](auto&... columns) { return Ref{ typename Ref::Pointers{ &columns[index]... } }; },
+                m_columns
+            );
+        }
+
+        ComponentTicks ticks(Entity entity) const
+        {
+            assert(m_entities.contains(entity) and "Retrieving non-existent component");
+            return m_ticks[m_entities.index_of(entity)];
+        }
+
+        void mark_changed(Entity entity, Tick tick)
+        {
+            assert(m_entities.contains(entity) and "Marking non-existent component");
+            m_ticks[m_entities.index_of(entity)].m_changed = tick;
+        }
+
+        bool contains(Entity entity) const { return m_entities.contains(entity); }
+
+        void entity_destroyed(Entity entity)
+        {
+            if (m_entities.contains(entity)) {
+                remove_data(entity);
+            }
+        }
+
+        std::size_t size() const { return m_entities.size(); }
+
+        // the entities in the order of the dense array, an entity is at its `index_of` there
+        std::span<const Entity> entities() const { return m_entities.entities(); }
+
+        std::size_t index_of(Entity entity) const
+        {
+            assert(m_entities.contains(entity) and "Retrieving non-existent component");
+            return m_entities.index_of(entity);
+        }
+
+        ComponentTicks& ticks_at(std::size_t index) { return m_ticks[index]; }
+
+        // mark every component as added at `tick`
+        void reset_ticks(Tick tick)
+        {
+            for (auto done = 0uz; done < size();) {
+                auto run = m_ticks.run(done, size() - done);
+                std::ranges::fill(run, ComponentTicks{ tick, tick });
+                done += run.size();
+            }
+        }
+
+        // the component at an index of the dense array, without marking it as changed
+        SoaRef<Comp> at(std::size_t index)
+        {
+            using Ref = SoaRef<Comp>;
+            return std::apply(
+                [&](auto&... columns) { return Ref{ typename Ref::Pointers{ &columns[index]... } }; },
+                m_columns
+            );
+        }
+
+        void reserve(std::size_t capacity)
+        {
+            m_entities.reserve(capacity);
+            reserve_columns(capacity);
+        }
+
+        // release the memory not needed by the current components, e.g. after destroying many entities
+        void shrink_to_fit()
+        {
+            m_entities.shrink_to_fit();
+            m_ticks.shrink(m_entities.size());
+            std::apply([&](auto&... columns) { (columns.shrink(m_entities.size()), ...); }, m_columns);
+        }
+
+        void save(SnapshotWriter& writer) const
+        {
+            m_entities.save(writer);
+            std::apply(
+                [&](const auto&... columns) { (writer.write_paged(columns, size()), ...); }, m_columns
+            );
+            writer.write_paged(m_ticks, size());
+        }
+
+        // replace the components with the ones saved, using the pages of the snapshot in place
+        bool load(SnapshotReader& reader)
+        {
+            auto loaded = m_entities.load(reader);
+            std::apply([&](auto&... columns) { (reader.adopt(columns), ...); }, m_columns);
+            reader.adopt(m_ticks);
+
+            // every entity must have its fields within the pages
+            auto covered = std::apply(
+                [&](const auto&... columns) { return ((columns.capacity() >= size()) and ...); }, m_columns
+            );
+            return loaded and reader.ok() and covered and m_ticks.capacity() >= size();
+        }
+
+    private:
+        template <typename Field>
+        using Column = util::PagedArray<Field, config::component_page_size>;
+
+        void reserve_columns(std::size_t capacity)
+        {
+            std::apply([&](auto&... columns) { (columns.reserve(capacity), ...); }, m_columns);
+            m_ticks.reserve(capacity);
+        }
+
+        // scatter the fields of a component into the columns
+        void store(std::size_t index, const Component& component)
+        {
+            auto handler = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                ((std::get<Is>(m_columns)[index] = component.*std::get<Is>(Layout::members)), ...);
+            };
+            handler(std::make_index_sequence<Layout::field_count>{});
+        }
+
+        // a column per field
+        typename Layout::template MapFields<Column> m_columns;
 
-        // bidirectional map of Entity and index to array
-        std::unordered_map<Entity, std::size_t> m_entity_to_index = {};
-        std::unordered_map<std::size_t, Entity> m_index_to_entity = {};
+        Column<ComponentTicks> m_ticks;
 
-        // total size of valid entries in the array
-        std::size_t m_size = 0;
+        // entities that have this component, position in the set is the index to the columns
+        SparseSet m_entities;
     };
 }
@@ -2,9 +2,18 @@
 
 #include "ecs/common.hpp"
 #include "ecs/component_array.hpp"
+#include "ecs/component_slot.hpp"
 #include "ecs/concepts.hpp"
+#include "ecs/signature_mapper.hpp"
+#include "ecs/snapshot.hpp"
+#include "ecs/sparse_set.hpp"
 #include "ecs/util/concepts.hpp"
 
+#include <cassert>
+#include <span>
+#include <tuple>
+#include <utility>
+
 namespace ecs
 {
     template <concepts::Component... Comps>
@@ -16,11 +25,31 @@ namespace ecs
 
         ComponentManager() = default;
 
+        // reserve room for a number of components of a type, the others still grow a page at a time
+        template <util::OneOf<Comps...> Comp>
+        void reserve(std::size_t capacity)
+        {
+            get_component_array<Comp>().reserve(capacity);
+        }
+
+        // release the memory not needed by the current components, e.g. after destroying many entities
+        void shrink_to_fit()
+        {
+            (get_component_array<Comps>().shrink_to_fit(), ...);
+        }
+
         template <util::OneOf<Comps...> Comp>
-        void add_component(Entity entity, Comp component)
+        void add_component(Entity entity, Comp component, Tick tick)
         {
             auto& comp_array = get_component_array<Comp>();
-            comp_array.insert_data(entity, component);
+            comp_array.insert_data(entity, component, tick);
+        }
+
+        // add components to many entities, the columns are indexed like the entities
+        template <util::OneOf<Comps...>... AddComps>
+        void add_components(Tick tick, std::span<const Entity> entities, std::span<const AddComps>... columns)
+        {
+            (get_component_array<AddComps>().insert_bulk(entities, columns, tick), ...);
         }
 
         template <util::OneOf<Comps...> Comp>
@@ -30,22 +59,205 @@ namespace ecs
             comp_array.remove_data(entity);
         }
 
+        // a reference, or a `SoaRef` proxy for components with a structure-of-arrays layout
         template <util::OneOf<Comps...> Comp, typename Self>
-        auto&& get_component(this Self&& self, Entity entity)
+        decltype(auto) get_component(this Self&& self, Entity entity)
         {
             auto&& comp_array = std::forward<Self>(self).template get_component_array<Comp>();
             return comp_array.get_data(entity);
         }
 
+        // like `get_component`, marking the component as changed at `tick`
+        template <util::OneOf<Comps...> Comp>
+        decltype(auto) get_component(Entity entity, Tick tick)
+        {
+            return get_component_array<Comp>().get_data(entity, tick);
+        }
+
+        template <util::OneOf<Comps...> Comp>
+            requires (not concepts::Tag<Comp>)
+        ComponentTicks ticks(Entity entity) const
+        {
+            return get_component_array<Comp>().ticks(entity);
+        }
+
+        template <util::OneOf<Comps...> Comp>
+            requires (not concepts::Tag<Comp>)
+        void mark_changed(Entity entity, Tick tick)
+        {
+            get_component_array<Comp>().mark_changed(entity, tick);
+        }
+
+        /**
+         * @brief Change the components of an entity from one signature to another at once.
+         *
+         * @param current The signature of the entity's current components.
+         * @param target The signature of the components the entity should end up with.
+         * @param values Indexed by component, pointers to the values of the components to write. Must be
+         * non-null for components in `target` but not in `current`, others are kept if null.
+         * @param tick The tick the written components are marked as added or changed at.
+         */
+        void set_components(
+            Entity                        entity,
+            Signature                     current,
+            Signature                     target,
+            std::span<const void* const> values,
+            Tick                          tick
+        )
+        {
+            assert(values.size() == sizeof...(Comps) and "Values must be indexed by component");
+
+            auto handler = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                (set_component<Comps>(entity, current, target, values[Is], tick), ...);
+            };
+            handler(std::make_index_sequence<sizeof...(Comps)>{});
+        }
+
+        /**
+         * @brief A position among the entities that have all the given components, see `for_each_in`.
+         *
+         * If the array of one of the components holds only those entities, its dense order is followed and
+         * that component is read without a lookup; otherwise the order is the one of the matched set.
+         */
+        template <util::OneOf<Comps...>... Qs>
+        class Cursor
+        {
+        public:
+            Cursor() = default;
+
+            Cursor(ComponentManager& manager, const SparseSet& matched, std::size_t position)
+                : m_manager{ &manager }
+                , m_entities{ matched.entities() }
+                , m_position{ position }
+            {
+                auto index = 0uz;
+                auto pick  = [&]<typename Q>() {
+                    if constexpr (not concepts::Tag<Q>) {
+                        auto& comp_array = manager.template get_component_array<Q>();
+                        if (m_driver == no_driver and comp_array.size() == matched.size()) {
+                            m_driver   = index;
+                            m_entities = comp_array.entities();
+                        }
+                    }
+                    ++index;
+                };
+                (pick.template operator()<Qs>(), ...);
+            }
+
+            std::size_t position() const { return m_position; }
+            Entity      entity() const { return m_entities[m_position]; }
+
+            std::tuple<ComponentSlot<Qs>...> slots() const
+            {
+                auto handler = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                    auto  entity  = m_entities[m_position];
+                    auto& manager = *m_manager;
+                    return std::tuple{ manager.template slot_of<Qs>(entity, m_position, Is == m_driver)... };
+                };
+                return handler(std::index_sequence_for<Qs...>{});
+            }
+
+            void advance() { ++m_position; }
+
+        private:
+            static constexpr std::size_t no_driver = sizeof...(Qs);
+
+            ComponentManager*       m_manager  = nullptr;
+            std::span<const Entity> m_entities = {};
+            std::size_t             m_position = 0;
+            std::size_t             m_driver   = no_driver;    // the component whose order is followed
+        };
+
+        template <util::OneOf<Comps...>... Qs>
+        Cursor<Qs...> cursor(const SparseSet& matched, std::size_t position)
+        {
+            assert(position <= matched.size() and "Position past the matched entities");
+            return { *this, matched, position };
+        }
+
+        /**
+         * @brief Iterate over part of the entities that have all the given components.
+         *
+         * @param matched The entities that have the components, as cached by the coordinator.
+         * @param begin The position of the first entity to visit, in the order of `Cursor`.
+         * @param end The position past the last one, at most the size of `matched`.
+         * @param fn Invoked as `fn(entity, slots...)` with a `ComponentSlot` for each of the components.
+         */
+        template <util::OneOf<Comps...>... Qs, typename Fn>
+        void for_each_in(const SparseSet& matched, std::size_t begin, std::size_t end, Fn&& fn)
+        {
+            assert(end <= matched.size() and "Iterating past the matched entities");
+
+            auto cursor = Cursor<Qs...>{ *this, matched, begin };
+            for (; cursor.position() < end; cursor.advance()) {
+                std::apply([&](auto... slots) { fn(cursor.entity(), slots...); }, cursor.slots());
+            }
+        }
+
         void entity_destroyed(Entity entity)
         {
             // fold expression to the rescue :D
-            (get_component_array<Comps>().remove_data(entity), ...);
+            (get_component_array<Comps>().entity_destroyed(entity), ...);
+        }
+
+        // mark every component as added at `tick`, e.g. after loading a snapshot
+        void reset_ticks(Tick tick)
+        {
+            (get_component_array<Comps>().reset_ticks(tick), ...);
+        }
+
+        static constexpr SnapshotStorage snapshot_storage = SnapshotStorage::SparseSet;
+
+        // the component arrays in order
+        void save(SnapshotWriter& writer) const
+        {
+            (get_component_array<Comps>().save(writer), ...);
+        }
+
+        // replace the components with the ones saved, false if the snapshot is corrupted
+        bool load(SnapshotReader& reader)
+        {
+            return (get_component_array<Comps>().load(reader) and ...);
         }
 
     private:
         using ComponentArrays = std::tuple<ComponentArray<Comps>...>;
 
+        template <util::OneOf<Comps...> Comp>
+        void set_component(Entity entity, Signature current, Signature target, const void* value, Tick tick)
+        {
+            constexpr auto bit = SignatureMapper<Comps...>::template map<Comp>();
+
+            auto& comp_array = get_component_array<Comp>();
+            auto  had        = current.test(bit);
+            auto  has        = target.test(bit);
+
+            if (had and not has) {
+                comp_array.remove_data(entity);
+            } else if (has and not had) {
+                assert(value != nullptr and "Added component must have a value");
+                comp_array.insert_data(entity, *static_cast<const Comp*>(value), tick);
+            } else if (has and value != nullptr) {
+                // a tag has no value to overwrite
+                if constexpr (not concepts::Tag<Comp>) {
+                    comp_array.get_data(entity, tick) = *static_cast<const Comp*>(value);
+                }
+            }
+        }
+
+        // the component of an entity, at `position` of its array if `direct` or looked up otherwise
+        template <util::OneOf<Comps...> Comp>
+        ComponentSlot<Comp> slot_of(Entity entity, std::size_t position, bool direct)
+        {
+            if constexpr (concepts::Tag<Comp>) {
+                return { tag_instance<Comp>, nullptr };
+            } else {
+                auto& comp_array = get_component_array<Comp>();
+                auto  index      = direct ? position : comp_array.index_of(entity);
+                return { comp_array.at(index), &comp_array.ticks_at(index) };
+            }
+        }
+
         template <util::OneOf<Comps...> Comp, typename Self>
         auto&& get_component_array(this Self&& self)
         {
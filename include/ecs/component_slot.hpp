@@ -0,0 +1,31 @@
+#pragma once
+
+#include "ecs/common.hpp"
+#include "ecs/concepts.hpp"
+#include "ecs/soa.hpp"
+
+#include <type_traits>
+
+namespace ecs
+{
+    // how a storage refers to a component it holds: a reference, a `SoaRef` proxy for a component with a
+    // structure-of-arrays layout, or a const reference to `tag_instance` for a tag
+    template <concepts::Component Comp>
+    using StoredRef = std::conditional_t<
+        concepts::SoaComponent<Comp>,
+        SoaRef<Comp>,
+        std::conditional_t<concepts::Tag<Comp>, const Comp&, Comp&>>;
+
+    /**
+     * @brief A component of an entity as a storage yields it while iterating, along with its ticks.
+     *
+     * Lets a view read the ticks and mark the component as changed without looking the entity up again.
+     * Tags have no ticks, their `m_ticks` is null.
+     */
+    template <concepts::Component Comp>
+    struct ComponentSlot
+    {
+        StoredRef<Comp> m_ref;
+        ComponentTicks* m_ticks;
+    };
+}
@@ -1,8 +1,13 @@
 #pragma once
 
 #include "ecs/common.hpp"
+#include "ecs/quantize.hpp"
+#include "ecs/soa.hpp"
+#include "ecs/tag.hpp"
 
 #include <concepts>
+#include <span>
+#include <tuple>
 #include <type_traits>
 
 namespace ecs::concepts
@@ -18,6 +23,28 @@ namespace ecs::concepts
                     and std::is_trivially_copy_assignable_v<T>       //
                     and std::is_trivially_destructible_v<T>;
 
+    // A component that is represented only by its signature bit, see `IsTag`.
+    template <typename T>
+    concept Tag = Component<T> and IsTag<T>::value;
+
+    // A component whose fields are stored in separate columns, see `SoaLayout`.
+    template <typename T>
+    concept SoaComponent = Component<T> and not IsTag<T>::value and requires {
+        typename SoaLayout<T>::Class;
+        requires std::same_as<typename SoaLayout<T>::Class, T>;
+    };
+
+    // A component replicated as multiples of a step, see `Quantize`. Every 4 bytes of it must be a float.
+    template <typename T>
+    concept QuantizedComponent = Component<T> and not IsTag<T>::value and requires {
+        { Quantize<T>::step } -> std::convertible_to<float>;
+        requires sizeof(T) % sizeof(float) == 0;
+    };
+
+    // A component, optionally const-qualified to declare read-only access.
+    template <typename T>
+    concept ComponentAccess = Component<std::remove_const_t<T>>;
+
     namespace detail
     {
         template <typename>
@@ -29,14 +56,51 @@ namespace ecs::concepts
         struct TupleOfComponents<std::tuple<Comps...>> : std::true_type
         {
         };
+
+        template <typename>
+        struct TupleOfComponentAccesses : std::false_type
+        {
+        };
+
+        template <ComponentAccess... Comps>
+        struct TupleOfComponentAccesses<std::tuple<Comps...>> : std::true_type
+        {
+        };
     }
 
     template <typename T>
     concept ComponentsTuple = detail::TupleOfComponents<T>::value;
 
     template <typename T>
-    concept HasComponents = requires (T sys, Entity entity) {
+    concept ComponentAccessTuple = detail::TupleOfComponentAccesses<T>::value;
+
+    // A component storage engine, e.g. `ComponentManager` or `ArchetypeManager`.
+    template <typename T>
+    concept ComponentStorage = requires (T storage, Entity entity) {
         typename T::Components;
         requires ComponentsTuple<typename T::Components>;
+        storage.entity_destroyed(entity);
+        storage.set_components(entity, Signature{}, Signature{}, std::span<const void* const>{}, Tick{});
+        storage.shrink_to_fit();
+    };
+
+    // A system declares the components its entities must have; const-qualified ones are only read.
+    template <typename T>
+    concept HasComponents = requires (T sys, Entity entity) {
+        typename T::Components;
+        requires ComponentAccessTuple<typename T::Components>;
+    };
+
+    // A system may declare every component it accesses, if it touches more than its `Components`.
+    template <typename T>
+    concept HasAccess = requires {
+        typename T::Access;
+        requires ComponentAccessTuple<typename T::Access>;
+    };
+
+    // A system that must run on the thread that calls `update`, e.g. because it uses a graphics context.
+    template <typename T>
+    concept MainThreadSystem = requires {
+        requires T::main_thread;
     };
 }
@@ -1,11 +1,43 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace ecs::config
 {
-    constexpr std::size_t max_entities   = 5000;
-    constexpr std::size_t max_components = 32;
+    // number of low bits of an entity that index its slot, the rest count the reuses of the slot
+    constexpr std::size_t entity_index_bits = 22;
+
+    // storages grow on demand up to `max_entities`, the capacity is only a hint of how many to expect
+    constexpr std::size_t max_entities     = (std::size_t{ 1 } << entity_index_bits) - 1;
+    constexpr std::size_t default_capacity = 5000;
+    constexpr std::size_t max_components   = 32;
+
+    // number of components per page of a `ComponentArray`, must be a power of two
+    constexpr std::size_t component_page_size = 1024;
+
+    // number of entries per page of the sparse index of a `SparseSet`, must be a power of two
+    constexpr std::size_t sparse_page_size = 4096;
+
+    // size in bytes of the chunks an archetype stores its rows in, and their alignment
+    constexpr std::size_t archetype_chunk_size      = 16 * 1024;
+    constexpr std::size_t archetype_chunk_alignment = 64;
+
+    // parallel iteration runs serially below this many entities, and splits the rest into chunks of at least
+    // `parallel_min_chunk` entities whose boundaries are multiples of a cache line worth of entities
+    constexpr std::size_t parallel_threshold = 1024;
+    constexpr std::size_t parallel_min_chunk = 256;
+    constexpr std::size_t cache_line_size    = 64;
+
+    // whether the system manager profiles the systems, see `Profiler`
+#ifdef SIMPLE_ECS_PROFILE
+    constexpr bool profile = true;
+#else
+    constexpr bool profile = false;
+#endif
+
+    // number of frames the profiler keeps the runs of
+    constexpr std::size_t profile_frames = 256;
 
     using EntityInner    = std::uint32_t;
     using SignatureInner = std::uint32_t;
@@ -1,27 +1,80 @@
 #pragma once
 
+#include "ecs/archetype_manager.hpp"
+#include "ecs/command_buffer.hpp"
 #include "ecs/common.hpp"
 #include "ecs/component_manager.hpp"
+#include "ecs/config.hpp"
 #include "ecs/concepts.hpp"
 #include "ecs/entity_manager.hpp"
+#include "ecs/observer.hpp"
+#include "ecs/profiler.hpp"
 #include "ecs/signature_mapper.hpp"
+#include "ecs/snapshot.hpp"
+#include "ecs/soa.hpp"
+#include "ecs/sparse_set.hpp"
 #include "ecs/system_manager.hpp"
+#include "ecs/thread_pool.hpp"
+#include "ecs/util/concepts.hpp"
+#include "ecs/util/mapped_file.hpp"
+#include "ecs/view.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <concepts>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace ecs
 {
-    template <concepts::Component... Comps>
-    class Coordinator
+    /**
+     * @brief Ties the entity, component, and system managers together.
+     *
+     * @tparam Storage The component storage engine, e.g. `ComponentManager` or `ArchetypeManager`.
+     * @tparam Comps All the components that can be attached to an entity.
+     */
+    template <concepts::ComponentStorage Storage, concepts::Component... Comps>
+        requires std::same_as<typename Storage::Components, std::tuple<Comps...>>
+    class BasicCoordinator
     {
     public:
         using EntityManager    = ecs::EntityManager;
-        using ComponentManager = ComponentManager<Comps...>;
-        using SystemManager    = SystemManager<Comps...>;
+        using ComponentManager = Storage;
+        using SystemManager    = ecs::SystemManager<BasicCoordinator>;
         using SigMapper        = SignatureMapper<Comps...>;
+        using CommandBuffer    = ecs::CommandBuffer<Comps...>;
+        using CommandBuffers   = ecs::CommandBuffers<Comps...>;
+        using ChangeSet        = ecs::ChangeSet<Comps...>;
+        using Observers        = ecs::Observers<Comps...>;
+
+        template <typename... Qs>
+        using Cursor = typename Storage::template Cursor<Qs...>;
 
-        Coordinator() = default;
+        BasicCoordinator() = default;
 
-        Coordinator(
+        /**
+         * @param capacity Number of entities expected to be alive at once, reserved for the bookkeeping kept
+         * per entity: its slot, its signature, and its record in the archetype storage. Components are not
+         * reserved, a type allocates nothing until an entity gets it and then grows a page or a chunk at a
+         * time. Everything grows past the capacity on demand, up to `config::max_entities`.
+         */
+        explicit BasicCoordinator(std::size_t capacity)
+            : m_entity_manager{ capacity }
+        {
+            // only the archetype storage keeps something per entity
+            if constexpr (requires { m_component_manager.reserve(capacity); }) {
+                m_component_manager.reserve(capacity);
+            }
+        }
+
+        BasicCoordinator(
             EntityManager&&    entity_manager,
             ComponentManager&& comp_manager,
             SystemManager&&    sys_manager
@@ -35,10 +88,44 @@ namespace ecs
         // entity methods
         // --------------
 
-        Entity create_entity() { return m_entity_manager.create_entity(); }
+        Entity create_entity()
+        {
+            Profiler::count_structural_changes();
+            return m_entity_manager.create_entity();
+        }
+
+        std::vector<Entity> create_entities(std::size_t count)
+        {
+            Profiler::count_structural_changes(count);
+            return m_entity_manager.create_entities(count);
+        }
+
+        /**
+         * @brief Release the memory not needed by the current entities and components.
+         *
+         * The storages only grow on their own, call this e.g. after destroying many entities.
+         */
+        void shrink_to_fit()
+        {
+            m_component_manager.shrink_to_fit();
+            m_system_manager.shrink_to_fit();
+        }
+
+        // whether the entity was created and not destroyed yet, a stale handle is never alive
+        bool is_alive(Entity entity) const { return m_entity_manager.is_alive(entity); }
+
+        // invoke `fn(entity, signature)` for each entity that has at least one component, by index
+        template <std::invocable<Entity, Signature> Fn>
+        void for_each_entity(Fn&& fn) const
+        {
+            m_entity_manager.for_each(std::forward<Fn>(fn));
+        }
 
         void destroy_entity(Entity entity)
         {
+            notify(ComponentEvent::Removed, entity, m_entity_manager.get_signature(entity));
+            Profiler::count_structural_changes();
+
             m_entity_manager.destroy_entity(entity);
             m_component_manager.entity_destroyed(entity);
             m_system_manager.entity_destroyed(entity);
@@ -52,13 +139,18 @@ namespace ecs
         template <concepts::Component Comp>
         void add_component(Entity entity, Comp component)
         {
-            m_component_manager.add_component(entity, component);
+            m_component_manager.add_component(entity, component, change_tick());
+            Profiler::count_structural_changes();
 
             auto signature = m_entity_manager.get_signature(entity);
             signature.set(SigMapper::template map<Comp>());
             m_entity_manager.set_signature(entity, signature);
 
             m_system_manager.entity_signature_changed(entity, signature);
+
+            if (m_observers.template observes<Comp>(ComponentEvent::Added)) {
+                m_observers.notify(ComponentEvent::Added, entity, component);
+            }
         }
 
         template <concepts::ComponentsTuple CompsTuple>
@@ -70,10 +162,55 @@ namespace ecs
             handler(std::make_index_sequence<std::tuple_size_v<CompsTuple>>{});
         }
 
+        /**
+         * @brief Add components to many entities at once.
+         *
+         * The storage is filled a column at a time, and the signature and queries of each entity are updated
+         * once for all the components.
+         *
+         * @param entities The entities, none of them may have any of the components yet.
+         * @param columns One span per component, indexed like the entities.
+         */
+        template <concepts::Component... AddComps>
+            requires util::NonEmpty<AddComps...>    //
+                 and util::Unique<AddComps...>      //
+                 and (util::OneOf<AddComps, Comps...> and ...)
+        void add_components(std::span<const Entity> entities, std::span<const AddComps>... columns)
+        {
+            assert(((columns.size() == entities.size()) and ...) and "Every entity must have the components");
+
+            constexpr auto added = SigMapper::template map_multiple<AddComps...>();
+
+            m_component_manager.template add_components<AddComps...>(change_tick(), entities, columns...);
+            Profiler::count_structural_changes(entities.size() * sizeof...(AddComps));
+
+            auto signatures = std::vector<Signature>{};
+            signatures.reserve(entities.size());
+
+            for (auto entity : entities) {
+                auto signature = m_entity_manager.get_signature(entity) | added;
+                m_entity_manager.set_signature(entity, signature);
+                signatures.push_back(signature);
+            }
+
+            m_system_manager.entities_signature_changed(entities, signatures);
+
+            if ((m_observers.observed(ComponentEvent::Added) & added) != Signature{}) {
+                for (auto entity : entities) {
+                    notify(ComponentEvent::Added, entity, added);
+                }
+            }
+        }
+
         template <concepts::Component Comp>
         void remove_component(Entity entity)
         {
+            if (m_observers.template observes<Comp>(ComponentEvent::Removed)) {
+                notify(ComponentEvent::Removed, entity, SigMapper::template map<Comp>());
+            }
+
             m_component_manager.template remove_component<Comp>(entity);
+            Profiler::count_structural_changes();
 
             auto signature = m_entity_manager.get_signature(entity);
             signature.reset(SigMapper::template map<Comp>());
@@ -91,30 +228,69 @@ namespace ecs
             handler(std::make_index_sequence<std::tuple_size_v<CompsTuple>>{});
         }
 
-        template <concepts::Component Comp, typename Self>
-        auto&& get_component(this Self&& self, Entity entity)
+        // a const-qualified component yields a const reference, a component with a structure-of-arrays layout
+        // yields a `SoaRef` proxy instead; getting a mutable one marks it as changed
+        template <typename Comp, typename Self>
+            requires concepts::Component<std::remove_const_t<Comp>>
+        decltype(auto) get_component(this Self&& self, Entity entity)
         {
+            using Base = std::remove_const_t<Comp>;
+
+            constexpr auto is_const = std::is_const_v<std::remove_reference_t<Self>>;
+
             auto&& comp_manager = std::forward<Self>(self).m_component_manager;
-            return comp_manager.template get_component<Comp>(entity);
+            if constexpr (std::is_const_v<Comp> and concepts::SoaComponent<Base>) {
+                return SoaRef<Comp>{ comp_manager.template get_component<Base>(entity) };
+            } else if constexpr (std::is_const_v<Comp>) {
+                return std::as_const(comp_manager.template get_component<Base>(entity));
+            } else if constexpr (is_const) {
+                return comp_manager.template get_component<Comp>(entity);
+            } else {
+                return comp_manager.template get_component<Comp>(entity, self.change_tick());
+            }
         }
 
-        template <concepts::ComponentsTuple CompsTuple, typename Self>
+        template <concepts::ComponentAccessTuple CompsTuple, typename Self>
         auto get_component_tuple(this Self&& self, Entity entity)
         {
+            auto get = [&]<typename Comp>() -> decltype(auto) {
+                return std::forward<Self>(self).template get_component<Comp>(entity);
+            };
+
+            // references are kept as references, proxies by value
             auto handler = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
-                return std::forward_as_tuple(
-                    std::forward<Self>(self).template get_component<std::tuple_element_t<Is, CompsTuple>>(
-                        entity
-                    )...
-                );
+                using Tuple = std::tuple<
+                    decltype(get.template operator()<std::tuple_element_t<Is, CompsTuple>>())...>;
+                return Tuple{ get.template operator()<std::tuple_element_t<Is, CompsTuple>>()... };
             };
             return handler(std::make_index_sequence<std::tuple_size_v<CompsTuple>>{});
         };
 
+        /**
+         * @brief Get the ticks a component of an entity was added and last changed at.
+         *
+         * Compare them against `ISystem::last_run` to know whether the component changed since a system last
+         * ran, or filter a view with `View::changed` and `View::added`.
+         */
+        template <concepts::Component Comp>
+            requires (not concepts::Tag<Comp>)
+        ComponentTicks component_ticks(Entity entity) const
+        {
+            return m_component_manager.template ticks<Comp>(entity);
+        }
+
+        // mark a component as changed without getting it mutably, e.g. after writing it through a pointer
+        template <concepts::Component Comp>
+            requires (not concepts::Tag<Comp>)
+        void mark_changed(Entity entity)
+        {
+            m_component_manager.template mark_changed<Comp>(entity, change_tick());
+        }
+
         template <concepts::Component Comp>
         bool has_component(Entity entity) const
         {
-            auto comp_signature   = SigMapper::template map<Comp>;
+            auto comp_signature   = SigMapper::template map<Comp>();
             auto entity_signature = m_entity_manager.get_signature(entity);
             return (comp_signature & entity_signature) == comp_signature;
         }
@@ -122,7 +298,7 @@ namespace ecs
         template <concepts::ComponentsTuple CompsTuple>
         bool has_component_tuple(Entity entity) const
         {
-            auto comps_signature  = SigMapper::template map_tuple<CompsTuple>;
+            auto comps_signature  = SigMapper::template map_tuple<CompsTuple>();
             auto entity_signature = m_entity_manager.get_signature(entity);
             return (comps_signature & entity_signature) == comps_signature;
         }
@@ -133,21 +309,422 @@ namespace ecs
         // --------------
 
         template <typename System, typename... Args>
-            requires concepts::HasComponents<System>                 //
-                 and std::derived_from<System, ISystem<Comps...>>    //
+            requires concepts::HasComponents<System>                         //
+                 and std::derived_from<System, ISystem<BasicCoordinator>>    //
                  and std::constructible_from<System, Args...>
         System& create_system(Args&&... args)
         {
-            return m_system_manager.template create_system<System>(std::forward<Args>(args)...);
+            auto populate = std::bind_front(&BasicCoordinator::populate_query, this);
+            return m_system_manager.template create_system<System>(populate, std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Require a system to finish before another one starts within a frame.
+         *
+         * @return False if the order would make a cycle with the previous ones, which are kept.
+         */
+        bool order_systems(const ISystem<BasicCoordinator>& before, const ISystem<BasicCoordinator>& after)
+        {
+            return m_system_manager.order(before, after);
+        }
+
+        /**
+         * @brief Run the systems, those that don't conflict with each other are run concurrently.
+         *
+         * The commands recorded by the systems are applied once they have all finished.
+         */
+        void update(Duration frame_time)
+        {
+            m_system_manager.update(*this, m_thread_pool, frame_time);
+            flush_commands();
+        }
+
+        ThreadPool& thread_pool() { return m_thread_pool; }
+
+        /**
+         * @brief The runs of the systems over the last frames, see `Profiler`.
+         *
+         * Nothing is recorded unless `SIMPLE_ECS_PROFILE` is defined. Must not be read while systems run.
+         */
+        const Profiler& profiler() const { return m_system_manager.profiler(); }
+
+        // --------------
+
+        // snapshot methods
+        // ----------------
+
+        /**
+         * @brief Write every entity and component into a file, to be restored with `load_snapshot`.
+         *
+         * The storage is written as it is in memory. Must not be called while the systems run.
+         */
+        SnapshotStatus save_snapshot(const std::filesystem::path& path) const
+        {
+            auto* file = std::fopen(path.string().c_str(), "wb");
+            if (file == nullptr) {
+                return SnapshotStatus::IoError;
+            }
+
+            auto writer = SnapshotWriter{ file };
+            writer.write_header<Comps...>(ComponentManager::snapshot_storage, change_tick());
+            m_entity_manager.save(writer);
+            m_component_manager.save(writer);
+
+            auto closed = std::fclose(file) == 0;
+            return writer.ok() and closed ? SnapshotStatus::Ok : SnapshotStatus::IoError;
+        }
+
+        /**
+         * @brief Replace every entity and component with the ones of a snapshot written by `save_snapshot`.
+         *
+         * The file is mapped into memory and the component storage uses its pages in place, copied only once
+         * they are written to, so the time it takes hardly depends on the number of entities. The file must
+         * not be modified while the coordinator uses it. The snapshot must have been written by a coordinator
+         * of the same type, otherwise nothing changes and the mismatch is returned.
+         *
+         * The systems and queries are refilled with the loaded entities. The change tick moves to the later
+         * of the current and the saved one, and every loaded component is marked as added at it: a view
+         * filtered on a system's `last_run`, or anything else comparing ticks from before the load, sees all
+         * of them as added and changed. Marking them copies the ticks out of the mapping. Observers are told
+         * that the replaced entities' components were removed and the loaded ones added.
+         *
+         * Must not be called while the systems run or commands are pending.
+         */
+        SnapshotStatus load_snapshot(const std::filesystem::path& path)
+        {
+            auto file = util::MappedFile::open(path);
+            if (file == nullptr) {
+                return SnapshotStatus::IoError;
+            }
+
+            auto reader = SnapshotReader{ std::move(file) };
+            auto tick   = Tick{};
+
+            auto status = reader.read_header<Comps...>(ComponentManager::snapshot_storage, tick);
+            if (status != SnapshotStatus::Ok) {
+                return status;
+            }
+
+            // loaded aside, so that a corrupted snapshot leaves the coordinator as it was
+            auto entity_manager    = EntityManager{ 0 };
+            auto component_manager = ComponentManager{};
+            if (not entity_manager.load(reader) or not component_manager.load(reader)) {
+                return SnapshotStatus::Corrupted;
+            }
+
+            notify_all(ComponentEvent::Removed);
+
+            m_entity_manager    = std::move(entity_manager);
+            m_component_manager = std::move(component_manager);
+
+            // the saved ticks may be older than the ones systems last ran at
+            auto current = change_tick();
+            tick         = is_newer(tick, current) ? tick : current;
+            m_change_tick.store(tick, std::memory_order_relaxed);
+            m_component_manager.reset_ticks(tick);
+
+            m_system_manager.rebuild_queries(std::bind_front(&BasicCoordinator::populate_query, this));
+            notify_all(ComponentEvent::Added);
+
+            return SnapshotStatus::Ok;
+        }
+
+        // ----------------
+
+        // observer methods
+        // ----------------
+
+        /**
+         * @brief Invoke `fn(entity, component)` after a component of a type is added to an entity.
+         *
+         * Observers are invoked on the thread making the change, which for deferred commands is the one
+         * flushing them, and get a copy of the component if it has a structure-of-arrays layout. They must
+         * not make structural changes themselves, but may record them into `commands()`; when invoked by
+         * `flush_commands` those are applied before it returns.
+         */
+        template <concepts::Component Comp, std::invocable<Entity, const Comp&> Fn>
+        ObserverId on_add(Fn&& fn)
+        {
+            return m_observers.template add<Comp>(ComponentEvent::Added, std::forward<Fn>(fn));
+        }
+
+        // invoke `fn(entity, component)` after an existing component is given a new value by a command, see
+        // `on_add`
+        template <concepts::Component Comp, std::invocable<Entity, const Comp&> Fn>
+        ObserverId on_set(Fn&& fn)
+        {
+            return m_observers.template add<Comp>(ComponentEvent::Replaced, std::forward<Fn>(fn));
+        }
+
+        // invoke `fn(entity, component)` before a component is removed from an entity, including when the
+        // entity is destroyed, see `on_add`
+        template <concepts::Component Comp, std::invocable<Entity, const Comp&> Fn>
+        ObserverId on_remove(Fn&& fn)
+        {
+            return m_observers.template add<Comp>(ComponentEvent::Removed, std::forward<Fn>(fn));
         }
 
-        void update(Duration frame_time) { m_system_manager.update(*this, frame_time); }
+        void remove_observer(ObserverId id) { m_observers.remove(id); }
+
+        // the tick that components changed now are marked with
+        Tick change_tick() const { return m_change_tick.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Advance the change tick, done by the system manager every time a system finishes.
+         *
+         * @return The tick before advancing, every change made since is marked with a later one.
+         */
+        Tick advance_change_tick() { return m_change_tick.fetch_add(1, std::memory_order_relaxed); }
 
         // --------------
 
+        // query methods
+        // -------------
+
+        /**
+         * @brief Get a view over the entities that have all the given components.
+         *
+         * The underlying entity set is cached per signature and shared with systems of the same signature.
+         */
+        template <typename... ViewComps>
+            requires util::NonEmpty<ViewComps...>
+                 and (util::OneOf<std::remove_const_t<ViewComps>, Comps...> and ...)
+        View<BasicCoordinator, ViewComps...> view()
+        {
+            constexpr auto signature = SigMapper::template map_multiple<std::remove_const_t<ViewComps>...>();
+
+            auto  populate = std::bind_front(&BasicCoordinator::populate_query, this);
+            auto& entities = m_system_manager.query(signature, populate);
+
+            return { *this, entities };
+        }
+
+        // a position among the entities of a view in the order the storage keeps them, see `for_each_in`
+        template <util::OneOf<Comps...>... Qs>
+        Cursor<Qs...> cursor(const SparseSet& matched, std::size_t position)
+        {
+            return m_component_manager.template cursor<Qs...>(matched, position);
+        }
+
+        /**
+         * @brief Iterate over part of the entities of a view in the order the storage keeps them.
+         *
+         * The hooks `View` iterates through, the storage walks its own columns instead of looking up each
+         * entity of `matched`.
+         *
+         * @param matched The entities that have the components, as cached for the view's signature.
+         * @param begin The position of the first entity to visit in the storage's order.
+         * @param end The position past the last one, at most the size of `matched`.
+         * @param fn Invoked as `fn(entity, slots...)` with a `ComponentSlot` for each of the components.
+         */
+        template <util::OneOf<Comps...>... Qs, typename Fn>
+        void for_each_in(const SparseSet& matched, std::size_t begin, std::size_t end, Fn&& fn)
+        {
+            m_component_manager.template for_each_in<Qs...>(matched, begin, end, std::forward<Fn>(fn));
+        }
+
+        /**
+         * @brief Invoke `fn(begin, end)` over chunks of `[0, count)` on the thread pool.
+         *
+         * Meant for splitting an entity set, or arrays indexed like one, across threads. The chunk
+         * boundaries are multiples of a cache line worth of entities, which only keeps writes from different
+         * chunks off each other's cache lines for arrays indexed like `[0, count)`, e.g. the columns a view
+         * walks in the storage's order. Components looked up per entity sit at their own dense indices, in
+         * another order, and get no such guarantee.
+         *
+         * @param count The number of entities.
+         * @param fn The function to invoke, must be safe to call concurrently on disjoint chunks.
+         * @param threshold Below this count `fn` is invoked once on the calling thread.
+         */
+        template <std::invocable<std::size_t, std::size_t> Fn>
+        void par_for(std::size_t count, Fn&& fn, std::size_t threshold = config::parallel_threshold)
+        {
+            constexpr auto alignment = std::max(config::cache_line_size / sizeof(Entity), 1uz);
+
+            auto threads = m_thread_pool.size() + 1;
+            if (count < threshold or threads == 1) {
+                fn(0uz, count);
+                return;
+            }
+
+            // a few chunks per thread so that the ones finishing early can pick up more
+            auto chunk_size = std::max(config::parallel_min_chunk, count / (threads * 4));
+            chunk_size      = (chunk_size + alignment - 1) / alignment * alignment;
+
+            if constexpr (config::profile) {
+                // the chunks count towards the system calling this, whichever thread runs them
+                auto* counter = Profiler::attributed();
+                auto  chunk   = [&fn, counter](std::size_t begin, std::size_t end) {
+                    auto attribution = Profiler::Attribution{ counter };
+                    fn(begin, end);
+                };
+                m_thread_pool.parallel_for(count, chunk_size, chunk);
+            } else {
+                m_thread_pool.parallel_for(count, chunk_size, std::forward<Fn>(fn));
+            }
+        }
+
+        // -------------
+
+        // deferred command methods
+        // ------------------------
+
+        /**
+         * @brief Get the command buffer of the calling thread.
+         *
+         * Structural changes recorded there are applied by `flush_commands`, which `update` calls after the
+         * systems have run. Safe to call from any thread.
+         */
+        CommandBuffer& commands() { return m_command_buffers.local(); }
+
+        /**
+         * @brief Apply and clear the commands recorded by every thread, must not be called concurrently with
+         * them.
+         *
+         * The buffers are emptied before their commands are applied, so the commands observers record while
+         * they are invoked land in fresh storage and are applied by another pass, until none are left.
+         */
+        void flush_commands()
+        {
+            auto create = std::bind_front(&BasicCoordinator::create_entity, this);
+
+            while (true) {
+                auto taken = 0uz;
+                m_command_buffers.for_each([&](CommandBuffer& buffer) {
+                    if (buffer.empty()) {
+                        return;
+                    }
+                    if (taken == m_flushing.size()) {
+                        m_flushing.emplace_back();
+                    }
+                    std::swap(m_flushing[taken++], buffer);
+                });
+
+                if (taken == 0) {
+                    return;
+                }
+
+                for (auto i = 0uz; i < taken; ++i) {
+                    m_flushing[i].collect(m_changes, create);
+                }
+                apply_changes();
+                for (auto i = 0uz; i < taken; ++i) {
+                    m_flushing[i].clear();
+                }
+            }
+        }
+
+        // apply and clear the commands of a buffer not owned by the coordinator, the commands observers
+        // record meanwhile are left for `flush_commands`, or for the next flush if recorded into this buffer
+        void flush(CommandBuffer& buffer)
+        {
+            auto taken = std::exchange(buffer, CommandBuffer{});
+            taken.collect(m_changes, std::bind_front(&BasicCoordinator::create_entity, this));
+            apply_changes();
+        }
+
+        // ------------------------
+
         // private:
+        // fill a newly created query with the entities that currently match its signature
+        void populate_query(Signature signature, SparseSet& entities)
+        {
+            m_entity_manager.for_each([&](Entity entity, Signature entity_signature) {
+                if (entity_signature.test(signature)) {
+                    entities.insert(entity);
+                }
+            });
+        }
+
+        // apply the collected changes, updating the storage, signature, and queries once per entity
+        void apply_changes()
+        {
+            for (const auto& change : m_changes.changes()) {
+                // e.g. destroyed by an earlier change or by another thread's buffer
+                if (not m_entity_manager.is_alive(change.m_entity)) {
+                    continue;
+                }
+
+                if (change.m_destroyed) {
+                    destroy_entity(change.m_entity);
+                    continue;
+                }
+
+                auto current = m_entity_manager.get_signature(change.m_entity);
+                auto target  = (current & ~change.m_removed) | change.m_added;
+
+                notify(ComponentEvent::Removed, change.m_entity, current & ~target);
+
+                m_component_manager.set_components(
+                    change.m_entity, current, target, change.m_values, change_tick()
+                );
+
+                if (target != current) {
+                    m_entity_manager.set_signature(change.m_entity, target);
+                    m_system_manager.entity_signature_changed(change.m_entity, target);
+                }
+
+                notify(ComponentEvent::Added, change.m_entity, target & ~current);
+                notify(ComponentEvent::Replaced, change.m_entity, change.m_added & current);
+            }
+            m_changes.clear();
+        }
+
+        // invoke the observers of an event for the components of an entity in `components`, with their
+        // current values
+        void notify(ComponentEvent event, Entity entity, Signature components)
+        {
+            components = components & m_observers.observed(event);
+            if (components == Signature{}) {
+                return;
+            }
+
+            auto notify_one = [&]<typename Comp>() {
+                if (not components.test(SigMapper::template map<Comp>())) {
+                    return;
+                }
+
+                auto&& component = std::as_const(*this).template get_component<const Comp>(entity);
+                if constexpr (concepts::SoaComponent<Comp>) {
+                    m_observers.notify(event, entity, static_cast<Comp>(component));
+                } else {
+                    m_observers.notify(event, entity, component);
+                }
+            };
+            (notify_one.template operator()<Comps>(), ...);
+        }
+
+        // notify the observers of an event for every component of every entity
+        void notify_all(ComponentEvent event)
+        {
+            if (m_observers.observed(event) == Signature{}) {
+                return;
+            }
+
+            for_each_entity([&](Entity entity, Signature components) { notify(event, entity, components); });
+        }
+
         EntityManager    m_entity_manager;
         ComponentManager m_component_manager;
         SystemManager    m_system_manager;
+        CommandBuffers   m_command_buffers;
+        ChangeSet        m_changes;
+
+        // the contents of the buffers being flushed, swapped with the buffers to keep their capacity
+        std::vector<CommandBuffer> m_flushing;
+
+        Observers        m_observers;
+        ThreadPool       m_thread_pool;
+
+        // starts past the initial last run of the systems, so that every component is new to them
+        std::atomic<Tick> m_change_tick = 1;
     };
+
+    // coordinator with the default, sparse set based, component storage
+    template <concepts::Component... Comps>
+    using Coordinator = BasicCoordinator<ComponentManager<Comps...>, Comps...>;
+
+    // coordinator that groups the components of entities with the same signature into archetypes
+    template <concepts::Component... Comps>
+    using ArchetypeCoordinator = BasicCoordinator<ArchetypeManager<Comps...>, Comps...>;
 }
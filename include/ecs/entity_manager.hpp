@@ -1,69 +1,161 @@
 #pragma once
 
 #include "ecs/common.hpp"
-#include "ecs/util/fixed_array.hpp"
+#include "ecs/snapshot.hpp"
 
 #include <cassert>
-#include <queue>
+#include <concepts>
+#include <span>
+#include <vector>
 
 namespace ecs
 {
+    /**
+     * @brief Hands out entity handles and keeps the signature of each living entity.
+     *
+     * Each slot holds the handle of the entity that uses it. The slots of destroyed entities form an
+     * intrusive free list: the index part of a free slot's handle is the index of the next free slot, while
+     * its generation is already bumped for the next entity that reuses the slot.
+     */
     class EntityManager
     {
     public:
-        EntityManager()
+        /**
+         * @param capacity Number of entities expected to be alive at once, creating entities doesn't
+         * allocate until it is exceeded.
+         */
+        explicit EntityManager(std::size_t capacity = config::default_capacity) { reserve(capacity); }
+
+        void reserve(std::size_t capacity)
         {
-            // initialize the queue with all possible entity IDs
-            for (Entity::Inner counter = 0; counter < config::max_entities; ++counter) {
-                m_available_entities.emplace(counter);
-            }
+            m_slots.reserve(capacity);
+            m_signatures.reserve(capacity);
         }
 
         Entity create_entity()
         {
             assert(m_living_entity_count < config::max_entities and "Too many entities in existence");
 
-            // take an id from the front of the queue
-            auto id = m_available_entities.front();
-            m_available_entities.pop();
-
             ++m_living_entity_count;
 
-            return id;
+            if (m_free_head == null_index) {
+                auto entity = Entity::make(static_cast<Entity::Inner>(m_slots.size()), 0);
+                m_slots.push_back(entity);
+                m_signatures.emplace_back();
+                return entity;
+            }
+
+            auto  index = m_free_head;
+            auto& slot  = m_slots[index];
+
+            m_free_head = slot.index();
+            slot        = Entity::make(index, slot.generation());
+
+            return slot;
+        }
+
+        std::vector<Entity> create_entities(std::size_t count)
+        {
+            assert(m_living_entity_count + count <= config::max_entities and "Too many entities");
+
+            auto entities = std::vector<Entity>{};
+            entities.reserve(count);
+
+            for (auto i = 0uz; i < count; ++i) {
+                entities.push_back(create_entity());
+            }
+
+            return entities;
         }
 
         void destroy_entity(Entity entity)
         {
-            assert(entity.m_inner < config::max_entities and "Entity out of range");
+            assert(is_alive(entity) and "Destroying a dead entity");
+
+            auto index = entity.index();
 
             // invalidate the destroyed entity's signature
-            m_signatures[entity.m_inner].reset(Signature{});
+            m_signatures[index] = Signature{};
+
+            // push the slot to the free list, bumping its generation so the destroyed handle goes stale
+            m_slots[index] = Entity::make(m_free_head, entity.generation() + 1);
+            m_free_head    = index;
 
-            // put the destoryed id at the back of the queue
-            m_available_entities.push(entity);
             --m_living_entity_count;
         }
 
-        void set_signature(Entity entity, Signature signature)
+        bool is_alive(Entity entity) const
         {
-            assert(entity.m_inner < config::max_entities and "Entity out of range");
+            auto index = entity.index();
+            return index < m_slots.size() and m_slots[index] == entity;
+        }
 
-            // put this entity's signature into the array
-            m_signatures[entity.m_inner] = signature;
+        void set_signature(Entity entity, Signature signature)
+        {
+            assert(is_alive(entity) and "Entity is not alive");
+            m_signatures[entity.index()] = signature;
         }
 
         Signature get_signature(Entity entity) const
         {
-            assert(entity.m_inner < config::max_entities and "Entity out of range");
+            assert(is_alive(entity) and "Entity is not alive");
+            return m_signatures[entity.index()];
+        }
 
-            // get the entity's signature from the array
-            return m_signatures[entity.m_inner];
+        /**
+         * @brief Invoke a function for each entity that has at least one component.
+         *
+         * @param fn Invoked as `fn(entity, signature)`.
+         */
+        template <std::invocable<Entity, Signature> Fn>
+        void for_each(Fn&& fn) const
+        {
+            for (auto index = 0uz; index < m_slots.size(); ++index) {
+                // dead entities have a null signature
+                if (auto signature = m_signatures[index]; signature != Signature{}) {
+                    fn(m_slots[index], signature);
+                }
+            }
+        }
+
+        Entity::Inner living_entity_count() const { return m_living_entity_count; }
+
+        // the slots and signatures, then the head of the free list and the living entity count
+        void save(SnapshotWriter& writer) const
+        {
+            writer.write_array(std::span{ m_slots });
+            writer.write_array(std::span{ m_signatures });
+            writer.write(m_free_head);
+            writer.write(m_living_entity_count);
+        }
+
+        // replace the entities with the ones saved, false if the snapshot is corrupted
+        bool load(SnapshotReader& reader)
+        {
+            auto slots      = reader.read_array<Entity>();
+            auto signatures = reader.read_array<Signature>();
+            auto free_head  = reader.read<Entity::Inner>();
+            auto living     = reader.read<Entity::Inner>();
+
+            if (not reader.ok() or slots.size() != signatures.size() or slots.size() > config::max_entities) {
+                return false;
+            }
+
+            m_slots.assign(slots.begin(), slots.end());
+            m_signatures.assign(signatures.begin(), signatures.end());
+            m_free_head           = free_head;
+            m_living_entity_count = living;
+
+            return true;
         }
 
     private:
-        std::queue<Entity>                                m_available_entities = {};
-        util::FixedArray<Signature, config::max_entities> m_signatures         = {};
+        static constexpr Entity::Inner null_index = Entity::index_mask;
+
+        std::vector<Entity>    m_slots      = {};
+        std::vector<Signature> m_signatures = {};
 
+        Entity::Inner m_free_head           = null_index;
         Entity::Inner m_living_entity_count = 0;
     };
 }
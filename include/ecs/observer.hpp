@@ -0,0 +1,138 @@
+#pragma once
+
+#include "ecs/common.hpp"
+#include "ecs/concepts.hpp"
+#include "ecs/signature_mapper.hpp"
+#include "ecs/util/concepts.hpp"
+#include "ecs/util/meta.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <vector>
+
+namespace ecs
+{
+    // what happened to a component of an entity
+    enum class ComponentEvent
+    {
+        Added,
+        Replaced,    // an existing component was given a new value
+        Removed,     // also when its entity is destroyed
+    };
+
+    // handle to a registered observer, to remove it with
+    struct ObserverId
+    {
+        std::size_t    m_component;
+        ComponentEvent m_event;
+        std::size_t    m_serial;
+
+        bool operator==(const ObserverId&) const = default;
+    };
+
+    /**
+     * @brief Callbacks invoked when components of a type are added, replaced, or removed.
+     *
+     * The observed components of each event are kept as a signature, so telling that nobody observes a
+     * component is a single bit test and components without observers cost nothing more.
+     *
+     * @tparam Comps All the components known to the coordinator.
+     */
+    template <concepts::Component... Comps>
+        requires util::Unique<Comps...>
+    class Observers
+    {
+    public:
+        static constexpr std::size_t event_count = 3;
+
+        template <typename Comp>
+        using Callback = std::function<void(Entity, const Comp&)>;
+
+        template <util::OneOf<Comps...> Comp>
+        ObserverId add(ComponentEvent event, Callback<Comp> callback)
+        {
+            auto id = ObserverId{ index_of<Comp>(), event, m_next_serial++ };
+
+            callbacks_of<Comp>(event).push_back({ id, std::move(callback) });
+            m_observed[to_index(event)].set(SigMapper::template map<Comp>());
+
+            return id;
+        }
+
+        // removing an observer that was already removed does nothing
+        void remove(ObserverId id)
+        {
+            auto handler = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                ((Is == id.m_component ? remove_from<Comps>(id) : void()), ...);
+            };
+            handler(std::index_sequence_for<Comps...>{});
+        }
+
+        // the components that have observers of an event
+        Signature observed(ComponentEvent event) const { return m_observed[to_index(event)]; }
+
+        template <util::OneOf<Comps...> Comp>
+        bool observes(ComponentEvent event) const
+        {
+            return observed(event).test(SigMapper::template map<Comp>());
+        }
+
+        // invoke the observers of an event in registration order
+        template <util::OneOf<Comps...> Comp>
+        void notify(ComponentEvent event, Entity entity, const Comp& component) const
+        {
+            for (const auto& entry : callbacks_of<Comp>(event)) {
+                entry.m_callback(entity, component);
+            }
+        }
+
+    private:
+        using SigMapper = SignatureMapper<Comps...>;
+
+        template <typename Comp>
+        struct Entry
+        {
+            ObserverId     m_id;
+            Callback<Comp> m_callback;
+        };
+
+        // per event
+        template <typename Comp>
+        using EventCallbacks = std::array<std::vector<Entry<Comp>>, event_count>;
+
+        static constexpr std::size_t to_index(ComponentEvent event)
+        {
+            return static_cast<std::size_t>(event);
+        }
+
+        template <util::OneOf<Comps...> Comp>
+        static constexpr std::size_t index_of()
+        {
+            return util::PackTraits<Comps...>::template index<Comp>();
+        }
+
+        template <util::OneOf<Comps...> Comp, typename Self>
+        auto&& callbacks_of(this Self&& self, ComponentEvent event)
+        {
+            return std::get<EventCallbacks<Comp>>(std::forward<Self>(self).m_callbacks)[to_index(event)];
+        }
+
+        template <util::OneOf<Comps...> Comp>
+        void remove_from(ObserverId id)
+        {
+            auto& callbacks = callbacks_of<Comp>(id.m_event);
+            std::erase_if(callbacks, [&](const Entry<Comp>& entry) { return entry.m_id == id; });
+
+            if (callbacks.empty()) {
+                m_observed[to_index(id.m_event)].reset(SigMapper::template map<Comp>());
+            }
+        }
+
+        std::tuple<EventCallbacks<Comps>...> m_callbacks;
+        std::array<Signature, event_count>   m_observed    = {};
+        std::size_t                          m_next_serial = 0;
+    };
+}
@@ -0,0 +1,305 @@
+#pragma once
+
+#include "ecs/common.hpp"
+#include "ecs/config.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <print>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ecs
+{
+    /**
+     * @brief Counts of durations in buckets that grow geometrically, four per power of two nanoseconds.
+     *
+     * Adding and removing a duration is constant time, so a histogram over a sliding window is kept by
+     * removing the durations that leave it. Quantiles are exact to within a quarter of their magnitude.
+     */
+    class Histogram
+    {
+    public:
+        static constexpr std::size_t sub_buckets  = 4;
+        static constexpr std::size_t bucket_count = 64 * sub_buckets;
+
+        void add(std::chrono::nanoseconds duration)
+        {
+            ++m_counts[bucket_of(duration)];
+            ++m_count;
+        }
+
+        void remove(std::chrono::nanoseconds duration)
+        {
+            assert(m_counts[bucket_of(duration)] > 0 and "Removing a duration that was not added");
+            --m_counts[bucket_of(duration)];
+            --m_count;
+        }
+
+        // the upper bound of the bucket the quantile falls in, zero if empty
+        std::chrono::nanoseconds quantile(double fraction) const
+        {
+            auto target     = static_cast<std::uint64_t>(fraction * static_cast<double>(m_count));
+            auto cumulative = std::uint64_t{ 0 };
+
+            for (auto bucket = 0uz; bucket < bucket_count; ++bucket) {
+                cumulative += m_counts[bucket];
+                if (cumulative > target or cumulative == m_count) {
+                    return m_count == 0 ? std::chrono::nanoseconds{ 0 } : lower_bound(bucket + 1);
+                }
+            }
+            return std::chrono::nanoseconds{ 0 };
+        }
+
+        std::uint64_t count() const { return m_count; }
+
+    private:
+        // the first values have a bucket each, then every power of two is split into `sub_buckets`
+        static std::size_t bucket_of(std::chrono::nanoseconds duration)
+        {
+            auto value = static_cast<std::uint64_t>(std::max(duration.count(), std::int64_t{ 0 }));
+            if (value < sub_buckets) {
+                return value;
+            }
+
+            auto octave = static_cast<std::size_t>(std::bit_width(value)) - 1;
+            auto sub    = (value >> (octave - 2)) & (sub_buckets - 1);
+            return (octave - 1) * sub_buckets + sub;
+        }
+
+        static std::chrono::nanoseconds lower_bound(std::size_t bucket)
+        {
+            if (bucket < sub_buckets) {
+                return std::chrono::nanoseconds{ bucket };
+            }
+
+            auto octave = bucket / sub_buckets + 1;
+            auto sub    = bucket % sub_buckets;
+            auto value  = (sub_buckets + sub) << (octave - 2);
+            return std::chrono::nanoseconds{ static_cast<std::int64_t>(value) };
+        }
+
+        std::array<std::uint32_t, bucket_count> m_counts = {};
+        std::uint64_t                           m_count  = 0;
+    };
+
+    /**
+     * @brief Records every run of the systems over the last frames.
+     *
+     * Fed by the system manager only when `SIMPLE_ECS_PROFILE` is defined, otherwise it holds a `NoProfiler`
+     * and every call is compiled out. Each run records its time span, its thread, the size of the system's
+     * entity set, and the number of structural changes the system made or recorded, on its own thread or in
+     * the chunks of its `par_for`. The runs of the last `config::profile_frames` frames are kept, to be
+     * exported as a Chrome trace, along with a histogram of the durations of each system over them.
+     *
+     * Runs of different systems are recorded concurrently; reading must not overlap with a frame.
+     */
+    class Profiler
+    {
+    public:
+        struct Sample
+        {
+            TimePoint     m_start              = {};
+            TimePoint     m_end                = {};
+            std::uint32_t m_thread             = 0;
+            std::uint32_t m_entities           = 0;
+            std::uint32_t m_structural_changes = 0;
+            bool          m_recorded           = false;
+        };
+
+        // a small index of the calling thread, assigned on first use
+        static std::uint32_t thread_index()
+        {
+            static auto       next  = std::atomic<std::uint32_t>{ 0 };
+            thread_local auto index = next.fetch_add(1, std::memory_order_relaxed);
+            return index;
+        }
+
+        using Counter = std::atomic<std::uint32_t>;
+
+        /**
+         * @brief Counts the structural changes made on the calling thread towards a run of a system.
+         *
+         * The previous counter of the thread is restored on destruction, so a thread waiting on its tasks can
+         * run those of other systems in between. Does nothing unless profiling is enabled.
+         */
+        class Attribution
+        {
+        public:
+            explicit Attribution(Counter* counter)
+            {
+                if constexpr (config::profile) {
+                    m_previous = std::exchange(s_counter, counter);
+                }
+            }
+
+            ~Attribution()
+            {
+                if constexpr (config::profile) {
+                    s_counter = m_previous;
+                }
+            }
+
+            Attribution(Attribution&&)            = delete;
+            Attribution& operator=(Attribution&&) = delete;
+
+        private:
+            Counter* m_previous = nullptr;
+        };
+
+        // called by the coordinator and the command buffers for each structural change
+        static void count_structural_changes(std::size_t count = 1)
+        {
+            if constexpr (config::profile) {
+                if (s_counter != nullptr) {
+                    s_counter->fetch_add(static_cast<std::uint32_t>(count), std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // the counter the calling thread counts structural changes towards, null outside of a system
+        static Counter* attributed() { return s_counter; }
+
+        // adding a system discards what was recorded so far
+        void add_system(std::string_view name)
+        {
+            m_names.push_back(name);
+            m_changes = std::vector<Counter>(m_names.size());
+            m_histograms.assign(m_names.size(), {});
+            m_samples.assign(config::profile_frames * m_names.size(), {});
+            m_frames.assign(config::profile_frames, {});
+            m_frame_count = 0;
+        }
+
+        void begin_frame()
+        {
+            auto& frame = m_frames[m_frame_count % config::profile_frames];
+
+            frame.m_start  = Clock::now();
+            frame.m_thread = thread_index();
+        }
+
+        void end_frame()
+        {
+            m_frames[m_frame_count % config::profile_frames].m_end = Clock::now();
+            ++m_frame_count;
+        }
+
+        // the counter of a system's structural changes, reset for a new run
+        Counter* begin_run(std::size_t system)
+        {
+            m_changes[system].store(0, std::memory_order_relaxed);
+            return &m_changes[system];
+        }
+
+        // record a finished run, along with the structural changes counted since `begin_run`
+        void record(std::size_t system, const Sample& sample)
+        {
+            auto  slot     = (m_frame_count % config::profile_frames) * m_names.size() + system;
+            auto& previous = m_samples[slot];
+
+            if (previous.m_recorded) {
+                m_histograms[system].remove(previous.m_end - previous.m_start);
+            }
+
+            previous                      = sample;
+            previous.m_structural_changes = m_changes[system].load(std::memory_order_relaxed);
+            previous.m_recorded           = true;
+            m_histograms[system].add(sample.m_end - sample.m_start);
+        }
+
+        std::size_t      system_count() const { return m_names.size(); }
+        std::string_view name(std::size_t system) const { return m_names[system]; }
+
+        // durations of a system over the recorded frames
+        const Histogram& histogram(std::size_t system) const { return m_histograms[system]; }
+
+        // number of frames recorded, up to `config::profile_frames`
+        std::size_t frame_count() const { return std::min(m_frame_count, config::profile_frames); }
+
+        /**
+         * @brief Write the recorded frames as Chrome trace events, for chrome://tracing or Perfetto.
+         *
+         * Frames and runs of systems are complete events on the track of the thread they ran on, with the
+         * entity and structural change counts as arguments of the runs.
+         */
+        void write_chrome_trace(std::FILE* file) const
+        {
+            auto first = m_frame_count - frame_count();
+            auto base  = frame_count() > 0 ? m_frames[first % config::profile_frames].m_start : TimePoint{};
+
+            auto micros = [&](TimePoint point) {
+                return std::chrono::duration<double, std::micro>{ point - base }.count();
+            };
+
+            auto separator = "";
+            auto event     = [&](std::string_view name, const Sample& sample, std::string_view args) {
+                std::print(
+                    file,
+                    R"({}{{"name":"{}","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":0,"tid":{},"args":{{{}}}}})",
+                    separator,
+                    name,
+                    micros(sample.m_start),
+                    micros(sample.m_end) - micros(sample.m_start),
+                    sample.m_thread,
+                    args
+                );
+                separator = ",\n";
+            };
+
+            std::println(file, R"({{"displayTimeUnit":"ns","traceEvents":[)");
+
+            for (auto frame = first; frame < m_frame_count; ++frame) {
+                auto index = frame % config::profile_frames;
+                event("frame", m_frames[index], "");
+
+                for (auto system = 0uz; system < m_names.size(); ++system) {
+                    const auto& sample = m_samples[index * m_names.size() + system];
+                    if (not sample.m_recorded) {
+                        continue;
+                    }
+
+                    auto args = std::format(
+                        R"("entities":{},"structural_changes":{})",
+                        sample.m_entities,
+                        sample.m_structural_changes
+                    );
+                    event(m_names[system], sample, args);
+                }
+            }
+
+            std::println(file, "");
+            std::println(file, "]}}");
+        }
+
+    private:
+        static inline thread_local Counter* s_counter = nullptr;
+
+        std::vector<std::string_view> m_names;
+        std::vector<Counter>          m_changes;       // by system, of the current or last run
+        std::vector<Histogram>        m_histograms;    // by system
+        std::vector<Sample>           m_samples;       // by frame then system
+        std::vector<Sample>           m_frames;        // ring of the last frames
+        std::size_t                   m_frame_count = 0;
+    };
+
+    /**
+     * @brief Stands in for `Profiler` in the system manager when profiling is disabled, empty and inert.
+     */
+    struct NoProfiler
+    {
+        void               add_system(std::string_view) {}
+        void               begin_frame() {}
+        void               end_frame() {}
+        Profiler::Counter* begin_run(std::size_t) { return nullptr; }
+        void               record(std::size_t, const Profiler::Sample&) {}
+    };
+}
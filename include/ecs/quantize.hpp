@@ -0,0 +1,25 @@
+#pragma once
+
+namespace ecs
+{
+    /**
+     * @brief Opt-in quantization of a component made only of floats, for replication.
+     *
+     * By default `ReplicationWriter` sends the bits of a changed component exactly. Specialize this with a
+     * `step` to have each float of the component sent as the nearest multiple of `step` instead, delta
+     * encoded against what the reader has, which takes a byte or two for small changes. The writer and the
+     * reader must agree on the step.
+     *
+     * @code
+     * template <>
+     * struct ecs::Quantize<Position>
+     * {
+     *     static constexpr float step = 1.0f / 1024.0f;
+     * };
+     * @endcode
+     */
+    template <typename T>
+    struct Quantize
+    {
+    };
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "ecs/common.hpp"
+#include "ecs/sparse_set.hpp"
+
+#include <concepts>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace ecs
+{
+    /**
+     * @brief Keeps, for each requested signature, the set of entities whose signature contains it.
+     *
+     * The sets are created on first request and then kept up to date incrementally as entity signatures
+     * change, so the entities matching a signature can be iterated densely at any time. References to the
+     * sets stay valid for the lifetime of the cache.
+     *
+     * Getting a set is safe to do from multiple threads at once; updating the sets is not.
+     */
+    class QueryCache
+    {
+    public:
+        QueryCache() = default;
+
+        // the mutex only guards lookups, a cache being moved can't be in use
+        QueryCache(QueryCache&& other) noexcept
+            : m_queries{ std::move(other.m_queries) }
+            , m_lookup{ std::move(other.m_lookup) }
+        {
+        }
+
+        /**
+         * @brief Get the set of entities matching a signature, creating it if it doesn't exist yet.
+         *
+         * @param signature The signature to match.
+         * @param populate Invoked as `populate(signature, set)` when the set is created, must insert every
+         * entity that currently matches the signature.
+         */
+        template <std::invocable<Signature, SparseSet&> Populate>
+        const SparseSet& get(Signature signature, Populate&& populate)
+        {
+            auto lock = std::scoped_lock{ m_mutex };
+
+            if (auto found = m_lookup.find(signature); found != m_lookup.end()) {
+                return m_queries[found->second]->m_entities;
+            }
+
+            auto& query = *m_queries.emplace_back(std::make_unique<Query>(signature));
+            m_lookup.emplace(signature, m_queries.size() - 1);
+            populate(signature, query.m_entities);
+
+            return query.m_entities;
+        }
+
+        void entity_signature_changed(Entity entity, Signature entity_signature)
+        {
+            for (auto& query : m_queries) {
+                auto matches  = entity_signature.test(query->m_signature);
+                auto contains = query->m_entities.contains(entity);
+
+                if (matches and not contains) {
+                    query->m_entities.insert(entity);
+                } else if (not matches and contains) {
+                    query->m_entities.remove(entity);
+                }
+            }
+        }
+
+        // update the sets for many entities at once, the signatures are indexed like the entities
+        void entities_signature_changed(
+            std::span<const Entity>    entities,
+            std::span<const Signature> signatures
+        )
+        {
+            for (auto& query : m_queries) {
+                auto& set = query->m_entities;
+                set.reserve(set.size() + entities.size());
+
+                for (auto i = 0uz; i < entities.size(); ++i) {
+                    auto matches  = signatures[i].test(query->m_signature);
+                    auto contains = set.contains(entities[i]);
+
+                    if (matches and not contains) {
+                        set.insert(entities[i]);
+                    } else if (not matches and contains) {
+                        set.remove(entities[i]);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Refill every set from scratch, e.g. after the entities were replaced all at once.
+         *
+         * @param populate Invoked as `populate(signature, set)` for every set, after clearing it.
+         */
+        template <std::invocable<Signature, SparseSet&> Populate>
+        void rebuild(Populate&& populate)
+        {
+            for (auto& query : m_queries) {
+                query->m_entities.clear();
+                populate(query->m_signature, query->m_entities);
+            }
+        }
+
+        void shrink_to_fit()
+        {
+            for (auto& query : m_queries) {
+                query->m_entities.shrink_to_fit();
+            }
+        }
+
+        void entity_destroyed(Entity entity)
+        {
+            for (auto& query : m_queries) {
+                if (query->m_entities.contains(entity)) {
+                    query->m_entities.remove(entity);
+                }
+            }
+        }
+
+    private:
+        struct Query
+        {
+            explicit Query(Signature signature)
+                : m_signature{ signature }
+            {
+            }
+
+            Signature m_signature;
+            SparseSet m_entities;
+        };
+
+        std::vector<std::unique_ptr<Query>>        m_queries;
+        std::unordered_map<Signature, std::size_t> m_lookup;
+        std::mutex                                 m_mutex;
+    };
+}
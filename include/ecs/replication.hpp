@@ -0,0 +1,865 @@
+#pragma once
+
+#include "ecs/common.hpp"
+#include "ecs/concepts.hpp"
+#include "ecs/config.hpp"
+#include "ecs/coordinator.hpp"
+#include "ecs/quantize.hpp"
+#include "ecs/snapshot.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cerrno>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ecs
+{
+    /**
+     * @brief The outcome of reading a replication frame.
+     *
+     * A frame that failed to apply may have been applied partially, the stream can't be continued after it.
+     */
+    enum class ReplicationStatus
+    {
+        Ok,
+        Closed,            // the source ended or failed before a whole frame was read
+        OutOfOrder,        // not the frame after the last one applied, e.g. one was lost or not acknowledged
+        LayoutMismatch,    // written with other components or quantization steps
+        Corrupted,         // malformed, or refers to entities or components the reader doesn't have
+    };
+
+    constexpr std::string_view to_string(ReplicationStatus status)
+    {
+        switch (status) {
+        case ReplicationStatus::Ok: return "ok";
+        case ReplicationStatus::Closed: return "closed";
+        case ReplicationStatus::OutOfOrder: return "out of order";
+        case ReplicationStatus::LayoutMismatch: return "component layout mismatch";
+        case ReplicationStatus::Corrupted: return "corrupted";
+        }
+        return "unknown";
+    }
+
+    namespace concepts
+    {
+        // Takes a whole frame and returns whether it was delivered, e.g. `replication::FdSink`.
+        template <typename T>
+        concept ByteSink = std::invocable<T&, std::span<const std::byte>>
+                       and std::convertible_to<std::invoke_result_t<T&, std::span<const std::byte>>, bool>;
+
+        // Fills the whole span and returns whether it could, e.g. `replication::FdSource`.
+        template <typename T>
+        concept ByteSource = std::invocable<T&, std::span<std::byte>>
+                         and std::convertible_to<std::invoke_result_t<T&, std::span<std::byte>>, bool>;
+    }
+
+    namespace replication
+    {
+        // a larger frame is rejected as corrupted instead of allocated
+        constexpr std::uint32_t max_frame_size = std::uint32_t{ 1 } << 30;
+
+        // LEB128: seven bits per byte from the lowest, the high bit is set on every byte but the last
+        inline void put_varint(std::vector<std::byte>& out, std::uint64_t value)
+        {
+            for (; value >= 0x80; value >>= 7) {
+                out.push_back(static_cast<std::byte>(value | 0x80));
+            }
+            out.push_back(static_cast<std::byte>(value));
+        }
+
+        // small magnitudes of either sign become small unsigned numbers
+        constexpr std::uint64_t zigzag(std::int64_t value)
+        {
+            return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+        }
+
+        constexpr std::int64_t unzigzag(std::uint64_t value)
+        {
+            return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+        }
+
+        /**
+         * @brief Reads the varints of a frame.
+         *
+         * Reading past the end of the frame or a varint longer than 64 bits is remembered, see `ok`, and
+         * yields zeroes.
+         */
+        class FrameReader
+        {
+        public:
+            explicit FrameReader(std::span<const std::byte> bytes)
+                : m_bytes{ bytes }
+            {
+            }
+
+            std::uint64_t varint()
+            {
+                auto value = std::uint64_t{ 0 };
+                for (auto shift = 0u; m_ok and shift < 64 and m_offset < m_bytes.size(); shift += 7) {
+                    auto byte  = static_cast<std::uint64_t>(m_bytes[m_offset++]);
+                    value     |= (byte & 0x7f) << shift;
+
+                    if ((byte & 0x80) == 0) {
+                        return value;
+                    }
+                }
+
+                m_ok = false;
+                return 0;
+            }
+
+            bool ok() const { return m_ok; }
+            bool done() const { return m_offset == m_bytes.size(); }
+
+        private:
+            std::span<const std::byte> m_bytes;
+            std::size_t                m_offset = 0;
+            bool                       m_ok     = true;
+        };
+
+        template <concepts::Component Comp>
+        constexpr float step_of()
+        {
+            if constexpr (concepts::QuantizedComponent<Comp>) {
+                return static_cast<float>(Quantize<Comp>::step);
+            } else {
+                return 0.0f;
+            }
+        }
+
+        // of the components and their quantization steps, the first frame starts with it
+        template <concepts::Component... Comps>
+        std::uint64_t layout_hash()
+        {
+            auto layouts = std::array<snapshot::ComponentLayout, sizeof...(Comps)>{
+                snapshot::layout_of<Comps>()...,
+            };
+            auto steps = std::array<float, sizeof...(Comps)>{ step_of<Comps>()... };
+
+            auto hash = snapshot::hash(std::as_bytes(std::span{ layouts }));
+            return snapshot::hash(std::as_bytes(std::span{ steps }), hash);
+        }
+
+        /**
+         * @brief Encodes a changed component as the differences of its 32-bit words from a base value.
+         *
+         * A difference is the xor of the bits of the two words, or for a `QuantizedComponent` the zigzag
+         * encoded difference of the nearest multiples of the step, so it is zero where the words are equal
+         * and small where they are close. For each group of 64 words, a frame holds a varint mask of the
+         * words that differ followed by their differences as varints.
+         */
+        template <concepts::Component Comp>
+        class WordCodec
+        {
+        public:
+            static constexpr std::size_t word_count = (sizeof(Comp) + 3) / 4;
+
+            using Words  = std::array<std::uint32_t, word_count>;
+            using Deltas = std::array<std::uint64_t, word_count>;
+
+            static Words words_of(const Comp& value)
+            {
+                auto words = Words{};
+                std::memcpy(words.data(), &value, sizeof(Comp));
+                return words;
+            }
+
+            static Comp value_of(const Words& words)
+            {
+                auto value = Comp{};
+                std::memcpy(static_cast<void*>(&value), words.data(), sizeof(Comp));
+                return value;
+            }
+
+            static Deltas diff(const Words& base, const Words& current)
+            {
+                auto deltas = Deltas{};
+                for (auto i = 0uz; i < word_count; ++i) {
+                    if constexpr (concepts::QuantizedComponent<Comp>) {
+                        deltas[i] = zigzag(multiple_of(current[i]) - multiple_of(base[i]));
+                    } else {
+                        deltas[i] = base[i] ^ current[i];
+                    }
+                }
+                return deltas;
+            }
+
+            // apply the differences to the base, the writer does it too to know what the reader ends up with;
+            // false if they can't have come from `diff`
+            static bool patch(Words& words, const Deltas& deltas)
+            {
+                for (auto i = 0uz; i < word_count; ++i) {
+                    if constexpr (concepts::QuantizedComponent<Comp>) {
+                        auto delta = unzigzag(deltas[i]);
+                        if (delta < -2 * max_multiple or delta > 2 * max_multiple) {
+                            return false;
+                        }
+                        words[i] = value_of_multiple(multiple_of(words[i]) + delta);
+                    } else {
+                        if (deltas[i] > 0xffff'ffff) {
+                            return false;
+                        }
+                        words[i] ^= static_cast<std::uint32_t>(deltas[i]);
+                    }
+                }
+                return true;
+            }
+
+            static bool unchanged(const Deltas& deltas)
+            {
+                return std::ranges::all_of(deltas, [](std::uint64_t delta) { return delta == 0; });
+            }
+
+            static void write(std::vector<std::byte>& out, const Deltas& deltas)
+            {
+                for (auto group = 0uz; group < word_count; group += 64) {
+                    auto end  = std::min(group + 64, word_count);
+                    auto mask = std::uint64_t{ 0 };
+
+                    for (auto i = group; i < end; ++i) {
+                        mask |= std::uint64_t{ deltas[i] != 0 } << (i - group);
+                    }
+                    put_varint(out, mask);
+
+                    for (auto i = group; i < end; ++i) {
+                        if (deltas[i] != 0) {
+                            put_varint(out, deltas[i]);
+                        }
+                    }
+                }
+            }
+
+            static Deltas read(FrameReader& in)
+            {
+                auto deltas = Deltas{};
+                for (auto group = 0uz; group < word_count; group += 64) {
+                    auto end  = std::min(group + 64, word_count);
+                    auto mask = in.varint();
+
+                    for (auto i = group; i < end; ++i) {
+                        if ((mask >> (i - group)) & 1) {
+                            deltas[i] = in.varint();
+                        }
+                    }
+                }
+                return deltas;
+            }
+
+        private:
+            // beyond it multiples of any step are no longer exact in a double
+            static constexpr std::int64_t max_multiple = std::int64_t{ 1 } << 53;
+
+            static double step() { return static_cast<double>(Quantize<Comp>::step); }
+
+            // the nearest multiple of the step to a float word, non-finite floats are taken as zero
+            static std::int64_t multiple_of(std::uint32_t word)
+            {
+                constexpr auto limit = static_cast<double>(max_multiple);
+
+                auto scaled = static_cast<double>(std::bit_cast<float>(word)) / step();
+                return std::isfinite(scaled) ? std::llround(std::clamp(scaled, -limit, limit)) : 0;
+            }
+
+            static std::uint32_t value_of_multiple(std::int64_t multiple)
+            {
+                auto value = static_cast<float>(static_cast<double>(multiple) * step());
+                return std::bit_cast<std::uint32_t>(value);
+            }
+        };
+
+        /**
+         * @brief Writes frames to a file descriptor: a file, a pipe, or a socket.
+         *
+         * A frame written partially breaks the stream. Writing to a socket whose reading end is closed fails,
+         * but writing to such a pipe raises `SIGPIPE`, ignore it to get a failed write instead.
+         */
+        struct FdSink
+        {
+            int m_fd;
+
+            bool operator()(std::span<const std::byte> bytes) const
+            {
+                while (not bytes.empty()) {
+                    auto written = ::send(m_fd, bytes.data(), bytes.size(), MSG_NOSIGNAL);
+                    if (written < 0 and errno == ENOTSOCK) {
+                        written = ::write(m_fd, bytes.data(), bytes.size());
+                    }
+                    if (written < 0 and errno == EINTR) {
+                        continue;
+                    }
+                    if (written <= 0) {
+                        return false;
+                    }
+                    bytes = bytes.subspan(static_cast<std::size_t>(written));
+                }
+                return true;
+            }
+        };
+
+        // reads frames from a file descriptor, fails at its end
+        struct FdSource
+        {
+            int m_fd;
+
+            bool operator()(std::span<std::byte> bytes) const
+            {
+                while (not bytes.empty()) {
+                    auto read = ::read(m_fd, bytes.data(), bytes.size());
+                    if (read < 0 and errno == EINTR) {
+                        continue;
+                    }
+                    if (read <= 0) {
+                        return false;
+                    }
+                    bytes = bytes.subspan(static_cast<std::size_t>(read));
+                }
+                return true;
+            }
+        };
+    }
+
+    template <typename Coordinator>
+    class ReplicationWriter;
+
+    /**
+     * @brief Encodes the changes to the entities and components of a coordinator as frames for a
+     * `ReplicationReader`.
+     *
+     * The writer keeps a copy of what the reader has, the state as of the last acknowledged frame: the last
+     * one its sink accepted. A frame holds only what differs from it, that is the entities destroyed and
+     * created, the components removed, and the components added or changed. Changed components are found
+     * through their change ticks and sent as the differences of their words, see `replication::WordCodec`, so
+     * the size of a frame follows the number of changes and not the number of entities.
+     *
+     * The first frame, and the first one after `reset`, holds the whole world. Entities without any component
+     * are not replicated. Frames are meant for a reliable, ordered stream, e.g. a file, a pipe, or a UNIX
+     * socket: each is a native 32-bit size followed by that many bytes, and the reader rejects a frame that
+     * doesn't follow the last one it applied.
+     */
+    template <concepts::ComponentStorage Storage, concepts::Component... Comps>
+    class ReplicationWriter<BasicCoordinator<Storage, Comps...>>
+    {
+    public:
+        using Coordinator = BasicCoordinator<Storage, Comps...>;
+        using SigMapper   = typename Coordinator::SigMapper;
+
+        /**
+         * @brief Encode the changes since the last acknowledged frame and give them to a sink as one frame.
+         *
+         * @return Whether the sink accepted the frame, which acknowledges it. Otherwise the next frame is
+         * encoded against the same state again, which is only right if none of this one reached the reader.
+         */
+        template <concepts::ByteSink Sink>
+        bool write(const Coordinator& coordinator, Sink&& sink)
+        {
+            encode(coordinator);
+
+            if (not std::invoke(sink, std::span<const std::byte>{ m_frame })) {
+                return false;
+            }
+
+            commit();
+            return true;
+        }
+
+        // forget what the reader has, the next frame then holds the whole world again, e.g. for a new reader
+        void reset()
+        {
+            m_entities.clear();
+            m_signatures.clear();
+            std::apply([](auto&... channels) { (channels.m_values.clear(), ...); }, m_channels);
+
+            m_frame_number = 0;
+            m_tick         = 0;
+        }
+
+        // the number of the last acknowledged frame, zero if none
+        std::uint64_t frame() const { return m_frame_number; }
+
+    private:
+        template <concepts::Component Comp>
+        struct Channel
+        {
+            void clear()
+            {
+                m_removed.clear();
+                m_changes.clear();
+                m_staged.clear();
+                m_change_count = 0;
+                m_last         = 0;
+            }
+
+            // starts an entry of `m_changes`, the indices ascend so they are written as differences
+            void add(Entity::Inner index)
+            {
+                replication::put_varint(m_changes, index - m_last);
+                m_last = index;
+                ++m_change_count;
+            }
+
+            std::vector<Comp>                           m_values;    // what the reader has, by entity index
+            std::vector<Entity::Inner>                  m_removed;
+            std::vector<std::byte>                      m_changes;
+            std::vector<std::pair<Entity::Inner, Comp>> m_staged;    // the values once acknowledged
+            std::size_t                                 m_change_count = 0;
+            Entity::Inner                               m_last         = 0;
+        };
+
+        // the entity the reader has at an index once the frame is acknowledged, null signature if none
+        struct Slot
+        {
+            Entity::Inner m_index;
+            Entity        m_entity;
+            Signature     m_signature;
+        };
+
+        void encode(const Coordinator& coordinator)
+        {
+            m_destroyed.clear();
+            m_created.clear();
+            m_staged_slots.clear();
+            std::apply([](auto&... channels) { (channels.clear(), ...); }, m_channels);
+
+            // one tick back to also catch the components changed after the last frame within its tick, the
+            // ones that didn't change are then filtered out by their value
+            auto since = m_tick - 1;
+            auto next  = 0uz;    // the replicated entities below it are either seen or destroyed
+
+            auto destroyed = [&](std::size_t index) {
+                if (index < m_signatures.size() and m_signatures[index] != Signature{}) {
+                    auto inner = static_cast<Entity::Inner>(index);
+                    m_destroyed.push_back(inner);
+                    m_staged_slots.push_back({ inner, m_entities[index], Signature{} });
+                }
+            };
+
+            coordinator.for_each_entity([&](Entity entity, Signature signature) {
+                auto index = entity.index();
+                for (auto end = std::min<std::size_t>(index, m_signatures.size()); next < end; ++next) {
+                    destroyed(next);
+                }
+                next = index + 1uz;
+
+                auto previous = index < m_signatures.size() ? m_signatures[index] : Signature{};
+                if (previous != Signature{} and m_entities[index] != entity) {
+                    destroyed(index);
+                    previous = Signature{};
+                }
+
+                if (previous == Signature{}) {
+                    m_created.push_back(entity);
+                }
+                if (previous != signature) {
+                    m_staged_slots.push_back({ index, entity, signature });
+                }
+
+                (diff<Comps>(coordinator, entity, previous, signature, since), ...);
+            });
+
+            for (; next < m_signatures.size(); ++next) {
+                destroyed(next);
+            }
+
+            assemble();
+            m_staged_tick = coordinator.change_tick();
+        }
+
+        template <concepts::Component Comp>
+        void diff(
+            const Coordinator& coordinator,
+            Entity             entity,
+            Signature          previous,
+            Signature          signature,
+            Tick               since
+        )
+        {
+            constexpr auto bit = SigMapper::template map<Comp>();
+
+            auto& channel = std::get<Channel<Comp>>(m_channels);
+            auto  index   = entity.index();
+            auto  had     = previous.test(bit);
+
+            if (not signature.test(bit)) {
+                if (had) {
+                    channel.m_removed.push_back(index);
+                }
+                return;
+            }
+
+            if constexpr (concepts::Tag<Comp>) {
+                if (not had) {
+                    channel.add(index);
+                }
+            } else {
+                using Codec = replication::WordCodec<Comp>;
+
+                if (had and not coordinator.template component_ticks<Comp>(entity).changed_since(since)) {
+                    return;
+                }
+
+                const Comp& value  = coordinator.template get_component<const Comp>(entity);
+                auto        base   = had ? Codec::words_of(channel.m_values[index]) : typename Codec::Words{};
+                auto        deltas = Codec::diff(base, Codec::words_of(value));
+
+                // e.g. written with the same value, an added component is sent even if it is all zeroes
+                if (had and Codec::unchanged(deltas)) {
+                    return;
+                }
+
+                channel.add(index);
+                Codec::write(channel.m_changes, deltas);
+
+                Codec::patch(base, deltas);
+                channel.m_staged.emplace_back(index, Codec::value_of(base));
+            }
+        }
+
+        // the size, the frame number, the layout hash if it is the first frame, the destroyed entities, the
+        // created ones with their generation, then for each component the entities it was removed from and
+        // the changed values
+        void assemble()
+        {
+            auto put_indices = [&](const std::vector<Entity::Inner>& indices) {
+                replication::put_varint(m_frame, indices.size());
+                for (auto last = Entity::Inner{ 0 }; auto index : indices) {
+                    replication::put_varint(m_frame, index - last);
+                    last = index;
+                }
+            };
+
+            m_frame.assign(sizeof(std::uint32_t), std::byte{ 0 });
+            replication::put_varint(m_frame, m_frame_number + 1);
+            if (m_frame_number == 0) {
+                replication::put_varint(m_frame, replication::layout_hash<Comps...>());
+            }
+
+            put_indices(m_destroyed);
+
+            replication::put_varint(m_frame, m_created.size());
+            for (auto last = Entity::Inner{ 0 }; auto entity : m_created) {
+                replication::put_varint(m_frame, entity.index() - last);
+                replication::put_varint(m_frame, entity.generation());
+                last = entity.index();
+            }
+
+            auto put_channel = [&](auto& channel) {
+                put_indices(channel.m_removed);
+                replication::put_varint(m_frame, channel.m_change_count);
+                m_frame.insert(m_frame.end(), channel.m_changes.begin(), channel.m_changes.end());
+            };
+            std::apply([&](auto&... channels) { (put_channel(channels), ...); }, m_channels);
+
+            auto size = static_cast<std::uint32_t>(m_frame.size() - sizeof(std::uint32_t));
+            assert(size <= replication::max_frame_size and "Replication frame is too large");
+            std::memcpy(m_frame.data(), &size, sizeof(size));
+        }
+
+        void commit()
+        {
+            for (const auto& slot : m_staged_slots) {
+                if (slot.m_index >= m_signatures.size()) {
+                    m_entities.resize(slot.m_index + 1uz, Entity{ 0 });
+                    m_signatures.resize(slot.m_index + 1uz);
+                }
+                m_entities[slot.m_index]   = slot.m_entity;
+                m_signatures[slot.m_index] = slot.m_signature;
+            }
+
+            auto commit_channel = [](auto& channel) {
+                for (const auto& [index, value] : channel.m_staged) {
+                    if (index >= channel.m_values.size()) {
+                        channel.m_values.resize(index + 1uz);
+                    }
+                    channel.m_values[index] = value;
+                }
+            };
+            std::apply([&](auto&... channels) { (commit_channel(channels), ...); }, m_channels);
+
+            m_tick = m_staged_tick;
+            ++m_frame_number;
+        }
+
+        std::vector<Entity>           m_entities;      // what the reader has, by entity index
+        std::vector<Signature>        m_signatures;    // null where the reader has no entity
+        std::tuple<Channel<Comps>...> m_channels;
+
+        std::vector<Entity::Inner> m_destroyed;
+        std::vector<Entity>        m_created;
+        std::vector<Slot>          m_staged_slots;
+        std::vector<std::byte>     m_frame;
+
+        std::uint64_t m_frame_number = 0;
+        Tick          m_tick         = 0;    // the change tick when the acknowledged frame was encoded
+        Tick          m_staged_tick  = 0;
+    };
+
+    template <typename Coordinator>
+    class ReplicationReader;
+
+    /**
+     * @brief Applies the frames of a `ReplicationWriter` to a coordinator.
+     *
+     * The reader creates an entity of its own for each entity of the writer, and adds, sets, and removes
+     * their components through the coordinator, so its observers and change ticks see the replicated changes
+     * like any other. Changes are applied on top of the values the reader has, so the replicated components
+     * must not be modified otherwise on the reading side.
+     */
+    template <concepts::ComponentStorage Storage, concepts::Component... Comps>
+    class ReplicationReader<BasicCoordinator<Storage, Comps...>>
+    {
+    public:
+        using Coordinator = BasicCoordinator<Storage, Comps...>;
+
+        // read a frame from the source and apply it, blocks as long as the source does
+        template <concepts::ByteSource Source>
+        ReplicationStatus read(Source&& source, Coordinator& coordinator)
+        {
+            auto size = std::uint32_t{ 0 };
+            if (not std::invoke(source, std::as_writable_bytes(std::span{ &size, 1 }))) {
+                return ReplicationStatus::Closed;
+            }
+            if (size > replication::max_frame_size) {
+                return ReplicationStatus::Corrupted;
+            }
+
+            m_buffer.resize(size);
+            if (not std::invoke(source, std::span{ m_buffer })) {
+                return ReplicationStatus::Closed;
+            }
+
+            return apply(m_buffer, coordinator);
+        }
+
+        // apply a frame without its size
+        ReplicationStatus apply(std::span<const std::byte> frame, Coordinator& coordinator)
+        {
+            auto in     = replication::FrameReader{ frame };
+            auto number = in.varint();
+
+            if (not in.ok()) {
+                return ReplicationStatus::Corrupted;
+            }
+            if (number != m_frame_number + 1) {
+                return ReplicationStatus::OutOfOrder;
+            }
+            if (number == 1 and in.varint() != replication::layout_hash<Comps...>()) {
+                return in.ok() ? ReplicationStatus::LayoutMismatch : ReplicationStatus::Corrupted;
+            }
+
+            auto destroyed = for_each_index(in, [&](std::size_t index) {
+                auto local = find(index);
+                if (local) {
+                    coordinator.destroy_entity(*local);
+                    m_entities[index].reset();
+                }
+                return local.has_value();
+            });
+
+            auto created = destroyed and for_each_index(in, [&](std::size_t index) {
+                auto generation = in.varint();
+                if (find(index) or generation > Entity::generation_mask) {
+                    return false;
+                }
+
+                if (index >= m_entities.size()) {
+                    m_entities.resize(index + 1);
+                }
+                auto remote = Entity::make(
+                    static_cast<Entity::Inner>(index), static_cast<Entity::Inner>(generation)
+                );
+                m_entities[index] = Mapping{ .m_remote = remote, .m_local = coordinator.create_entity() };
+                return true;
+            });
+
+            auto applied = created and (apply_channel<Comps>(in, coordinator) and ...);
+            if (not applied or not in.ok() or not in.done()) {
+                return ReplicationStatus::Corrupted;
+            }
+
+            m_frame_number = number;
+            return ReplicationStatus::Ok;
+        }
+
+        // the number of the last frame applied, zero if none
+        std::uint64_t frame() const { return m_frame_number; }
+
+        // the entity of the reader for an entity of the writer, if that one is replicated
+        std::optional<Entity> local(Entity remote) const
+        {
+            auto index = remote.index();
+            if (index < m_entities.size() and m_entities[index] and m_entities[index]->m_remote == remote) {
+                return m_entities[index]->m_local;
+            }
+            return std::nullopt;
+        }
+
+        /**
+         * @brief Count the entities of the writer's coordinator that the reader's doesn't mirror.
+         *
+         * A replicated entity is mirrored if the reader has an entity for it with the same components and the
+         * same values, or values within a step for a `QuantizedComponent`. The entities of the reader that
+         * mirror none of the writer's are counted too. Meant for checking a replica: both coordinators must
+         * be as of the last frame applied.
+         *
+         * @param source The coordinator of the writer.
+         * @param mirror The coordinator the frames were applied to.
+         */
+        std::size_t mismatches(const Coordinator& source, const Coordinator& mirror) const
+        {
+            auto count      = 0uz;
+            auto replicated = 0uz;
+
+            source.for_each_entity([&](Entity entity, Signature) {
+                ++replicated;
+
+                auto mirrored = local(entity);
+                if (not mirrored or not mirror.is_alive(*mirrored)) {
+                    ++count;
+                } else if (not (same<Comps>(source, entity, mirror, *mirrored) and ...)) {
+                    ++count;
+                }
+            });
+
+            auto mirrored = 0uz;
+            mirror.for_each_entity([&](Entity, Signature) { ++mirrored; });
+
+            return count + (mirrored > replicated ? mirrored - replicated : 0uz);
+        }
+
+    private:
+        // whether an entity of the reader has a component of an entity of the writer, with the same value
+        template <concepts::Component Comp>
+        static bool same(const Coordinator& source, Entity entity, const Coordinator& mirror, Entity mirrored)
+        {
+            auto has = source.template has_component<Comp>(entity);
+            if (has != mirror.template has_component<Comp>(mirrored)) {
+                return false;
+            }
+            if constexpr (concepts::Tag<Comp>) {
+                return true;
+            } else {
+                if (not has) {
+                    return true;
+                }
+
+                using Codec = replication::WordCodec<Comp>;
+
+                const Comp& expected = source.template get_component<const Comp>(entity);
+                const Comp& actual   = mirror.template get_component<const Comp>(mirrored);
+
+                auto expected_words = Codec::words_of(expected);
+                auto actual_words   = Codec::words_of(actual);
+
+                if constexpr (concepts::QuantizedComponent<Comp>) {
+                    constexpr auto step = replication::step_of<Comp>();
+                    return std::ranges::equal(expected_words, actual_words, [&](auto lhs, auto rhs) {
+                        return std::abs(std::bit_cast<float>(lhs) - std::bit_cast<float>(rhs)) <= step;
+                    });
+                } else if constexpr (std::equality_comparable<Comp>) {
+                    return expected == actual;
+                } else {
+                    return expected_words == actual_words;
+                }
+            }
+        }
+
+        // invoke `fn(index)` for each index of a list written as a count and differences, stops at a failure
+        template <std::invocable<std::size_t> Fn>
+        static bool for_each_index(replication::FrameReader& in, Fn&& fn)
+        {
+            auto count = in.varint();
+            for (auto i = 0uz, index = 0uz; i < count and in.ok(); ++i) {
+                auto delta = in.varint();
+                if (delta > config::max_entities - index) {
+                    return false;
+                }
+
+                index += delta;
+                if (not in.ok() or not fn(index)) {
+                    return false;
+                }
+            }
+            return in.ok();
+        }
+
+        template <concepts::Component Comp>
+        bool apply_channel(replication::FrameReader& in, Coordinator& coordinator)
+        {
+            auto removed = for_each_index(in, [&](std::size_t index) {
+                auto local = find(index);
+                if (not local or not coordinator.template has_component<Comp>(*local)) {
+                    return false;
+                }
+                coordinator.template remove_component<Comp>(*local);
+                return true;
+            });
+
+            return removed and for_each_index(in, [&](std::size_t index) {
+                auto local = find(index);
+                if (not local) {
+                    return false;
+                }
+
+                auto has = coordinator.template has_component<Comp>(*local);
+                if constexpr (concepts::Tag<Comp>) {
+                    if (has) {
+                        return false;
+                    }
+                    coordinator.add_component(*local, Comp{});
+                } else {
+                    using Codec = replication::WordCodec<Comp>;
+
+                    auto words = typename Codec::Words{};
+                    if (has) {
+                        words = Codec::words_of(coordinator.template get_component<const Comp>(*local));
+                    }
+                    if (not Codec::patch(words, Codec::read(in)) or not in.ok()) {
+                        return false;
+                    }
+
+                    if (has) {
+                        coordinator.template get_component<Comp>(*local) = Codec::value_of(words);
+                    } else {
+                        coordinator.add_component(*local, Codec::value_of(words));
+                    }
+                }
+                return true;
+            });
+        }
+
+        struct Mapping
+        {
+            Entity m_remote;
+            Entity m_local;
+        };
+
+        std::optional<Entity> find(std::size_t index) const
+        {
+            if (index < m_entities.size() and m_entities[index]) {
+                return m_entities[index]->m_local;
+            }
+            return std::nullopt;
+        }
+
+        std::vector<std::optional<Mapping>> m_entities;    // by entity index of the writer
+        std::vector<std::byte>              m_buffer;
+        std::uint64_t                       m_frame_number = 0;
+    };
+}
@@ -0,0 +1,347 @@
+#pragma once
+
+#include "ecs/common.hpp"
+#include "ecs/concepts.hpp"
+#include "ecs/config.hpp"
+#include "ecs/soa.hpp"
+#include "ecs/util/mapped_file.hpp"
+#include "ecs/util/meta.hpp"
+#include "ecs/util/paged_array.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace ecs
+{
+    /**
+     * @brief The outcome of saving or loading a snapshot.
+     *
+     * Loading checks the header, the layouts of the components, and that every array lies within the file.
+     * The contents of the arrays are trusted, a snapshot is only meant to be read by the program that wrote
+     * it, or a build of it with the same components.
+     */
+    enum class SnapshotStatus
+    {
+        Ok,
+        IoError,            // the file can't be opened, mapped, or written
+        NotASnapshot,       // wrong magic, or written with the other byte order
+        VersionMismatch,    // written by another version of the format
+        ConfigMismatch,     // written with another component storage or `config` constants
+        LayoutMismatch,     // the components differ in name, order, size, alignment, or fields
+        Corrupted,          // an array reaches past the end of the file, or the tables disagree
+    };
+
+    constexpr std::string_view to_string(SnapshotStatus status)
+    {
+        switch (status) {
+        case SnapshotStatus::Ok: return "ok";
+        case SnapshotStatus::IoError: return "i/o error";
+        case SnapshotStatus::NotASnapshot: return "not a snapshot";
+        case SnapshotStatus::VersionMismatch: return "version mismatch";
+        case SnapshotStatus::ConfigMismatch: return "config mismatch";
+        case SnapshotStatus::LayoutMismatch: return "component layout mismatch";
+        case SnapshotStatus::Corrupted: return "corrupted";
+        }
+        return "unknown";
+    }
+
+    // the component storage engine a snapshot was written from, their data is laid out differently
+    enum class SnapshotStorage : std::uint32_t
+    {
+        SparseSet = 1,
+        Archetype = 2,
+    };
+
+    namespace snapshot
+    {
+        constexpr std::uint64_t magic   = 0x50414e5353434553;    // "SECSSNAP" in little endian
+        constexpr std::uint32_t version = 1;
+
+        // arrays start at multiples of this, enough for any component and for archetype chunks
+        constexpr std::size_t alignment = config::archetype_chunk_alignment;
+        static_assert(util::MappedFile::alignment % alignment == 0, "Arrays are aligned more than a file");
+
+        struct Header
+        {
+            std::uint64_t   m_magic               = magic;
+            std::uint32_t   m_version             = version;
+            SnapshotStorage m_storage             = {};
+            std::uint32_t   m_component_count     = 0;
+            std::uint32_t   m_entity_index_bits   = config::entity_index_bits;
+            std::uint32_t   m_component_page_size = config::component_page_size;
+            std::uint32_t   m_sparse_page_size    = config::sparse_page_size;
+            std::uint32_t   m_chunk_size          = config::archetype_chunk_size;
+            Tick            m_change_tick         = 0;
+
+            bool operator==(const Header&) const = default;
+        };
+
+        // what a component looked like to the program that wrote the snapshot
+        struct ComponentLayout
+        {
+            std::uint64_t m_type_hash   = 0;    // of the name the compiler spells
+            std::uint64_t m_layout_hash = 0;    // of whether it is a tag, and of its fields if split
+            std::uint32_t m_size        = 0;
+            std::uint32_t m_align       = 0;
+
+            bool operator==(const ComponentLayout&) const = default;
+        };
+
+        constexpr std::uint64_t fnv_offset_basis = 0xcbf29ce484222325;
+        constexpr std::uint64_t fnv_prime        = 0x100000001b3;
+
+        // FNV-1a, continuing from `seed`
+        constexpr std::uint64_t hash(std::span<const std::byte> bytes, std::uint64_t seed = fnv_offset_basis)
+        {
+            for (auto byte : bytes) {
+                seed = (seed ^ static_cast<std::uint64_t>(byte)) * fnv_prime;
+            }
+            return seed;
+        }
+
+        template <concepts::Component Comp>
+        ComponentLayout layout_of()
+        {
+            auto name   = util::type_name<Comp>();
+            auto is_tag = concepts::Tag<Comp>;
+            auto layout = ComponentLayout{
+                .m_type_hash   = hash(std::as_bytes(std::span{ name })),
+                .m_layout_hash = hash(std::as_bytes(std::span{ &is_tag, 1 })),
+                .m_size        = sizeof(Comp),
+                .m_align       = alignof(Comp),
+            };
+
+            if constexpr (concepts::SoaComponent<Comp>) {
+                const auto& offsets = SoaLayout<Comp>::field_offsets();
+                const auto& sizes   = SoaLayout<Comp>::field_sizes;
+
+                layout.m_layout_hash = hash(std::as_bytes(std::span{ offsets }), layout.m_layout_hash);
+                layout.m_layout_hash = hash(std::as_bytes(std::span{ sizes }), layout.m_layout_hash);
+            }
+
+            return layout;
+        }
+    }
+
+    /**
+     * @brief Writes a snapshot sequentially into a file.
+     *
+     * A snapshot is a header, the layouts of the components, then whatever the entity manager and the
+     * component storage write, in that order. Values are written as they are in memory, arrays as their
+     * element count followed by their elements, starting at a multiple of `snapshot::alignment` so that they
+     * can be used in place once the file is mapped. A failed write is remembered, see `ok`.
+     */
+    class SnapshotWriter
+    {
+    public:
+        explicit SnapshotWriter(std::FILE* file)
+            : m_file{ file }
+        {
+        }
+
+        template <concepts::Component... Comps>
+        void write_header(SnapshotStorage storage, Tick change_tick)
+        {
+            auto header = snapshot::Header{
+                .m_storage         = storage,
+                .m_component_count = sizeof...(Comps),
+                .m_change_tick     = change_tick,
+            };
+            write(header);
+
+            auto layouts = std::array{ snapshot::layout_of<Comps>()... };
+            write_array(std::span<const snapshot::ComponentLayout>{ layouts });
+        }
+
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        void write(const T& value)
+        {
+            write_bytes(std::as_bytes(std::span{ &value, 1 }));
+        }
+
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        void write_array(std::span<const T> elements)
+        {
+            begin_array<T>(elements.size());
+            write_bytes(std::as_bytes(elements));
+        }
+
+        /**
+         * @brief Write the first elements of a paged array, padded with zeroes to a whole number of pages.
+         *
+         * Read back with `SnapshotReader::adopt`.
+         */
+        template <typename T, std::size_t PageSize>
+        void write_paged(const util::PagedArray<T, PageSize>& array, std::size_t size)
+        {
+            auto padded = (size + PageSize - 1) / PageSize * PageSize;
+            begin_array<T>(padded);
+
+            for (auto done = 0uz; done < size;) {
+                auto run = array.run(done, size - done);
+                write_bytes(std::as_bytes(run));
+                done += run.size();
+            }
+            write_zeroes((padded - size) * sizeof(T));
+        }
+
+        // the count of an array whose elements are then written by the caller, aligning them
+        template <typename T>
+        void begin_array(std::size_t count)
+        {
+            static_assert(alignof(T) <= snapshot::alignment, "Element alignment is larger than the arrays'");
+
+            write(static_cast<std::uint64_t>(count));
+            write_zeroes((snapshot::alignment - m_offset % snapshot::alignment) % snapshot::alignment);
+        }
+
+        void write_bytes(std::span<const std::byte> bytes)
+        {
+            if (m_ok and not bytes.empty()) {
+                m_ok = std::fwrite(bytes.data(), 1, bytes.size(), m_file) == bytes.size();
+            }
+            m_offset += bytes.size();
+        }
+
+        void write_zeroes(std::size_t count)
+        {
+            static constexpr auto zeroes = std::array<std::byte, 4096>{};
+
+            for (; count > 0; count -= std::min(count, zeroes.size())) {
+                write_bytes(std::span{ zeroes }.first(std::min(count, zeroes.size())));
+            }
+        }
+
+        // whether everything was written so far
+        bool ok() const { return m_ok; }
+
+    private:
+        std::FILE*  m_file;
+        std::size_t m_offset = 0;
+        bool        m_ok     = true;
+    };
+
+    /**
+     * @brief Reads a snapshot written by `SnapshotWriter` in place, from a mapped file.
+     *
+     * Arrays are not copied, they are returned as spans into the mapping, which stays alive as long as
+     * `owner` does. Reading past the end of the file is remembered, see `ok`, and yields empty values.
+     */
+    class SnapshotReader
+    {
+    public:
+        explicit SnapshotReader(std::shared_ptr<util::MappedFile> file)
+            : m_file{ std::move(file) }
+            , m_bytes{ m_file->bytes() }
+        {
+        }
+
+        // check that the snapshot was written by a program with the same configuration and components
+        template <concepts::Component... Comps>
+        SnapshotStatus read_header(SnapshotStorage storage, Tick& change_tick)
+        {
+            auto header = read<snapshot::Header>();
+            if (not m_ok or header.m_magic != snapshot::magic) {
+                return SnapshotStatus::NotASnapshot;
+            }
+            if (header.m_version != snapshot::version) {
+                return SnapshotStatus::VersionMismatch;
+            }
+
+            auto expected = snapshot::Header{
+                .m_storage         = storage,
+                .m_component_count = sizeof...(Comps),
+                .m_change_tick     = header.m_change_tick,
+            };
+            if (header != expected) {
+                return SnapshotStatus::ConfigMismatch;
+            }
+
+            auto layouts = read_array<snapshot::ComponentLayout>();
+            if (not std::ranges::equal(layouts, std::array{ snapshot::layout_of<Comps>()... })) {
+                return m_ok ? SnapshotStatus::LayoutMismatch : SnapshotStatus::Corrupted;
+            }
+
+            change_tick = header.m_change_tick;
+            return SnapshotStatus::Ok;
+        }
+
+        template <typename T>
+            requires std::is_trivially_copyable_v<T> and std::default_initializable<T>
+        T read()
+        {
+            auto value = T{};
+            if (auto bytes = take(sizeof(T)); not bytes.empty()) {
+                std::memcpy(&value, bytes.data(), sizeof(T));
+            }
+            return value;
+        }
+
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        std::span<T> read_array()
+        {
+            auto count = read<std::uint64_t>();
+            skip((snapshot::alignment - m_offset % snapshot::alignment) % snapshot::alignment);
+
+            // checked against the size of the file before multiplying, so that it can't overflow
+            if (count > m_bytes.size() / sizeof(T)) {
+                m_ok = false;
+                return {};
+            }
+
+            auto bytes = take(count * sizeof(T));
+            return { std::launder(reinterpret_cast<T*>(bytes.data())), bytes.empty() ? 0 : count };
+        }
+
+        // make a paged array use the pages written by `SnapshotWriter::write_paged` in place
+        template <typename T, std::size_t PageSize>
+        void adopt(util::PagedArray<T, PageSize>& array)
+        {
+            auto elements = read_array<T>();
+            if (elements.size() % PageSize != 0) {
+                m_ok = false;
+                return;
+            }
+            array.adopt(elements, m_file);
+        }
+
+        void skip(std::size_t count) { take(count); }
+
+        // whether everything read so far was within the file
+        bool ok() const { return m_ok; }
+
+        // the mapping the arrays point into
+        const std::shared_ptr<util::MappedFile>& owner() const { return m_file; }
+
+    private:
+        std::span<std::byte> take(std::size_t count)
+        {
+            if (not m_ok or count > m_bytes.size() - m_offset) {
+                m_ok = false;
+                return {};
+            }
+
+            auto bytes  = m_bytes.subspan(m_offset, count);
+            m_offset   += count;
+            return bytes;
+        }
+
+        std::shared_ptr<util::MappedFile> m_file;
+        std::span<std::byte>              m_bytes;
+        std::size_t                       m_offset = 0;
+        bool                              m_ok     = true;
+    };
+}
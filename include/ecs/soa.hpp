@@ -0,0 +1,277 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ecs
+{
+    /**
+     * @brief Opt-in structure-of-arrays layout of a component.
+     *
+     * By default a component is stored whole. Specialize this, deriving from `SoaFields` with every data
+     * member of the component, to have the storages keep each member in its own column instead; a loop that
+     * touches only some of the members then doesn't drag the others through the cache. Such a component is
+     * yielded as a `SoaRef` proxy instead of a reference.
+     *
+     * @code
+     * template <>
+     * struct ecs::SoaLayout<Transform>
+     *     : ecs::SoaFields<&Transform::m_position, &Transform::m_scale, &Transform::m_rotation>
+     * {
+     * };
+     * @endcode
+     */
+    template <typename T>
+    struct SoaLayout
+    {
+    };
+
+    namespace detail
+    {
+        template <typename>
+        struct MemberPointer
+        {
+            static_assert(false, "not a pointer to data member");
+        };
+
+        template <typename C, typename F>
+        struct MemberPointer<F C::*>
+        {
+            using Class = C;
+            using Field = F;
+        };
+
+        // converts to anything, an aggregate has as many members as the most of these it can be built from
+        struct AnyMember
+        {
+            template <typename T>
+            operator T&() const;
+        };
+
+        template <typename T, typename... Members>
+        constexpr std::size_t member_count()
+        {
+            if constexpr (requires { T{ Members{}..., AnyMember{} }; }) {
+                return member_count<T, Members..., AnyMember>();
+            } else {
+                return sizeof...(Members);
+            }
+        }
+
+        template <auto Lhs, auto Rhs>
+        constexpr bool same_member()
+        {
+            if constexpr (std::is_same_v<decltype(Lhs), decltype(Rhs)>) {
+                return Lhs == Rhs;
+            } else {
+                return false;
+            }
+        }
+    }
+
+    /**
+     * @brief The fields of a component with a structure-of-arrays layout, in column order.
+     *
+     * Pointers to the data members of the component are given as the template arguments, all of them must be
+     * listed once: members left out would be lost when a component is stored. The component must be an
+     * aggregate for the storages to check that.
+     */
+    template <auto First, auto... Rest>
+    struct SoaFields
+    {
+        using Class  = typename detail::MemberPointer<decltype(First)>::Class;
+        using Fields = std::tuple<
+            typename detail::MemberPointer<decltype(First)>::Field,
+            typename detail::MemberPointer<decltype(Rest)>::Field...>;
+
+        template <template <typename> typename Wrap>
+        using MapFields = std::tuple<
+            Wrap<typename detail::MemberPointer<decltype(First)>::Field>,
+            Wrap<typename detail::MemberPointer<decltype(Rest)>::Field>...>;
+
+        template <std::size_t I>
+        using FieldAt = std::tuple_element_t<I, Fields>;
+
+        static constexpr std::size_t field_count = 1 + sizeof...(Rest);
+        static constexpr auto        members     = std::tuple{ First, Rest... };
+
+        static_assert(
+            (std::is_same_v<Class, typename detail::MemberPointer<decltype(Rest)>::Class> and ...),
+            "Fields must be members of the same component"
+        );
+
+        static constexpr auto field_sizes = std::array{
+            sizeof(typename detail::MemberPointer<decltype(First)>::Field),
+            sizeof(typename detail::MemberPointer<decltype(Rest)>::Field)...,
+        };
+
+        static constexpr auto field_aligns = std::array{
+            alignof(typename detail::MemberPointer<decltype(First)>::Field),
+            alignof(typename detail::MemberPointer<decltype(Rest)>::Field)...,
+        };
+
+        template <auto Member>
+        static constexpr std::size_t index_of()
+        {
+            constexpr auto matches = std::array{ detail::same_member<Member, First>(),
+                                                 detail::same_member<Member, Rest>()... };
+            for (auto i = 0uz; i < field_count; ++i) {
+                if (matches[i]) {
+                    return i;
+                }
+            }
+            return field_count;
+        }
+
+        // byte offsets of the fields inside the component, member pointers can't be turned into offsets at
+        // compile time so they are measured once on a default constructed instance
+        static const std::array<std::size_t, field_count>& field_offsets()
+        {
+            static const auto offsets = [] {
+                auto  object = Class{};
+                auto* base   = reinterpret_cast<const std::byte*>(&object);
+                auto  offset = [&](auto member) {
+                    auto* field = reinterpret_cast<const std::byte*>(&(object.*member));
+                    return static_cast<std::size_t>(field - base);
+                };
+                return std::array{ offset(First), offset(Rest)... };
+            }();
+            return offsets;
+        }
+    };
+
+    namespace detail
+    {
+        // checked by the storages, nothing stops a layout from leaving out or repeating a member otherwise
+        template <typename Layout>
+        consteval bool lists_every_member()
+        {
+            using Class = typename Layout::Class;
+
+            constexpr auto total = [] {
+                auto sum = 0uz;
+                for (auto size : Layout::field_sizes) {
+                    sum += size;
+                }
+                return sum;
+            }();
+
+            // the first field with each member is the field itself
+            constexpr auto distinct = []<std::size_t... Is>(std::index_sequence<Is...>) {
+                return ((Layout::template index_of<std::get<Is>(Layout::members)>() == Is) and ...);
+            }(std::make_index_sequence<Layout::field_count>{});
+
+            static_assert(distinct, "A member can't be in the layout twice");
+            static_assert(std::is_aggregate_v<Class>, "A component with a SoA layout must be an aggregate");
+            static_assert(member_count<Class>() == Layout::field_count, "Every member must be in the layout");
+            static_assert(total <= sizeof(Class), "The fields can't be larger than the component");
+
+            return true;
+        }
+    }
+
+    /**
+     * @brief A reference to a component with a structure-of-arrays layout, its fields live apart.
+     *
+     * The proxy is cheap to copy and all copies refer to the same component. Assigning a component value to
+     * it writes through to the columns, converting it to the component type reads every field. Structured
+     * bindings yield references to the fields in the order of the layout.
+     *
+     * @tparam Comp The component type, const-qualified for read-only access.
+     */
+    template <typename Comp>
+    class SoaRef
+    {
+    public:
+        using Component = std::remove_const_t<Comp>;
+        using Layout    = SoaLayout<Component>;
+
+        template <std::size_t I>
+        using FieldAt = std::conditional_t<
+            std::is_const_v<Comp>,
+            const typename Layout::template FieldAt<I>,
+            typename Layout::template FieldAt<I>>;
+
+        template <typename Field>
+        using FieldPtr = std::conditional_t<std::is_const_v<Comp>, const Field*, Field*>;
+
+        using Pointers = typename Layout::template MapFields<FieldPtr>;
+
+        explicit SoaRef(Pointers fields)
+            : m_fields{ fields }
+        {
+        }
+
+        // a mutable reference converts to a read-only one
+        SoaRef(const SoaRef<Component>& other)
+            requires std::is_const_v<Comp>
+            : m_fields{ other.fields() }
+        {
+        }
+
+        SoaRef(const SoaRef&) = default;
+
+        // assignment writes through, like assigning to a reference
+        const SoaRef& operator=(const SoaRef& other) const
+            requires (not std::is_const_v<Comp>)
+        {
+            return *this = static_cast<Component>(other);
+        }
+
+        const SoaRef& operator=(const Component& value) const
+            requires (not std::is_const_v<Comp>)
+        {
+            auto handler = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                ((get<Is>() = value.*std::get<Is>(Layout::members)), ...);
+            };
+            handler(std::make_index_sequence<Layout::field_count>{});
+            return *this;
+        }
+
+        operator Component() const
+        {
+            auto value   = Component{};
+            auto handler = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                ((value.*std::get<Is>(Layout::members) = get<Is>()), ...);
+            };
+            handler(std::make_index_sequence<Layout::field_count>{});
+            return value;
+        }
+
+        template <std::size_t I>
+        FieldAt<I>& get() const noexcept
+        {
+            return *std::get<I>(m_fields);
+        }
+
+        // get a field by its member pointer, e.g. `ref.get<&Transform::m_position>()`
+        template <auto Member>
+            requires std::is_member_object_pointer_v<decltype(Member)>
+        auto& get() const noexcept
+        {
+            constexpr auto index = Layout::template index_of<Member>();
+            static_assert(index < Layout::field_count, "Member is not a field of the layout");
+            return get<index>();
+        }
+
+        const Pointers& fields() const noexcept { return m_fields; }
+
+    private:
+        Pointers m_fields;
+    };
+}
+
+template <typename Comp>
+struct std::tuple_size<ecs::SoaRef<Comp>>
+    : std::integral_constant<std::size_t, ecs::SoaRef<Comp>::Layout::field_count>
+{
+};
+
+template <std::size_t I, typename Comp>
+struct std::tuple_element<I, ecs::SoaRef<Comp>>
+{
+    using type = typename ecs::SoaRef<Comp>::template FieldAt<I>;
+};
@@ -0,0 +1,223 @@
+#pragma once
+
+#include "ecs/common.hpp"
+#include "ecs/config.hpp"
+#include "ecs/snapshot.hpp"
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace ecs
+{
+    /**
+     * @brief A set of entities with O(1) insertion, removal, and lookup.
+     *
+     * The entities are kept densely packed in a vector while a paged sparse index maps each entity to its
+     * position in the dense vector. A page of the sparse index is only allocated when an entity that falls
+     * into it is inserted, so a handful of entities with large ids don't cost a full array.
+     *
+     * The sparse index is keyed by the entity index, the generation is checked against the dense array.
+     */
+    class SparseSet
+    {
+    public:
+        using Index = config::EntityInner;
+
+        static constexpr Index       null_index = std::numeric_limits<Index>::max();
+        static constexpr std::size_t page_size  = config::sparse_page_size;
+
+        static_assert(std::has_single_bit(page_size), "Sparse page size must be a power of two");
+
+        SparseSet() = default;
+
+        explicit SparseSet(std::size_t capacity) { reserve(capacity); }
+
+        bool contains(Entity entity) const noexcept
+        {
+            auto page = page_of(entity);
+            if (page >= m_sparse.size() or m_sparse[page] == nullptr) {
+                return false;
+            }
+
+            auto index = (*m_sparse[page])[offset_of(entity)];
+            return index != null_index and m_dense[index] == entity;
+        }
+
+        /**
+         * @brief Get the position of an entity in the dense array.
+         *
+         * The entity must be in the set, no check is done outside of debug build.
+         */
+        std::size_t index_of(Entity entity) const noexcept
+        {
+            assert(contains(entity) and "Entity is not in the set");
+            return (*m_sparse[page_of(entity)])[offset_of(entity)];
+        }
+
+        /**
+         * @brief Insert an entity at the end of the dense array.
+         *
+         * @return The position of the inserted entity in the dense array.
+         */
+        std::size_t insert(Entity entity)
+        {
+            assert(not contains(entity) and "Entity inserted into the set more than once");
+
+            auto index = m_dense.size();
+
+            slot(entity) = static_cast<Index>(index);
+            m_dense.push_back(entity);
+
+            return index;
+        }
+
+        /**
+         * @brief Remove an entity by moving the last entity in the dense array into its place.
+         *
+         * @return The position the removed entity used to occupy, which is now occupied by the last entity
+         * (unless the removed entity was the last one).
+         */
+        std::size_t remove(Entity entity)
+        {
+            assert(contains(entity) and "Removing entity that is not in the set");
+
+            auto& removed_slot = slot(entity);
+            auto  index        = removed_slot;
+            auto  last         = m_dense.back();
+
+            m_dense[index] = last;
+            slot(last)     = index;
+            removed_slot   = null_index;    // must be done last in case the entity is the last one
+
+            m_dense.pop_back();
+
+            return index;
+        }
+
+        void clear() noexcept
+        {
+            for (auto entity : m_dense) {
+                slot(entity) = null_index;
+            }
+            m_dense.clear();
+        }
+
+        void reserve(std::size_t capacity)
+        {
+            m_dense.reserve(capacity);
+            m_sparse.reserve((capacity + page_size - 1) / page_size);
+        }
+
+        // release the dense capacity and the sparse pages not needed by the current entities
+        void shrink_to_fit()
+        {
+            m_dense.shrink_to_fit();
+
+            auto used = std::vector<bool>(m_sparse.size(), false);
+            for (auto entity : m_dense) {
+                used[page_of(entity)] = true;
+            }
+
+            for (auto page = 0uz; page < m_sparse.size(); ++page) {
+                if (not used[page]) {
+                    m_sparse[page].reset();
+                }
+            }
+
+            while (not m_sparse.empty() and m_sparse.back() == nullptr) {
+                m_sparse.pop_back();
+            }
+            m_sparse.shrink_to_fit();
+        }
+
+        // the dense array, then the index of every allocated sparse page followed by the pages themselves
+        void save(SnapshotWriter& writer) const
+        {
+            writer.write_array(entities());
+
+            auto pages = std::vector<std::uint32_t>{};
+            for (auto page = 0uz; page < m_sparse.size(); ++page) {
+                if (m_sparse[page] != nullptr) {
+                    pages.push_back(static_cast<std::uint32_t>(page));
+                }
+            }
+
+            writer.write_array(std::span<const std::uint32_t>{ pages });
+            for (auto page : pages) {
+                writer.write_array(std::span<const Index>{ *m_sparse[page] });
+            }
+        }
+
+        // replace the entities with the ones saved, false if the snapshot is corrupted
+        bool load(SnapshotReader& reader)
+        {
+            constexpr auto max_pages = (config::max_entities >> page_shift) + 1;
+
+            auto dense = reader.read_array<Entity>();
+            auto pages = reader.read_array<std::uint32_t>();
+
+            m_dense.assign(dense.begin(), dense.end());
+            m_sparse.clear();
+
+            for (auto page : pages) {
+                auto indices = reader.read_array<Index>();
+                if (page >= max_pages or indices.size() != page_size) {
+                    return false;
+                }
+
+                if (page >= m_sparse.size()) {
+                    m_sparse.resize(page + 1);
+                }
+                m_sparse[page] = std::make_unique_for_overwrite<Page>();
+                std::memcpy(m_sparse[page]->data(), indices.data(), indices.size_bytes());
+            }
+
+            return reader.ok();
+        }
+
+        std::size_t size() const noexcept { return m_dense.size(); }
+        bool        empty() const noexcept { return m_dense.empty(); }
+
+        std::span<const Entity> entities() const noexcept { return m_dense; }
+
+        const Entity* begin() const noexcept { return m_dense.data(); }
+        const Entity* end() const noexcept { return m_dense.data() + m_dense.size(); }
+
+    private:
+        using Page = std::array<Index, page_size>;
+
+        static constexpr std::size_t page_shift = std::countr_zero(page_size);
+        static constexpr std::size_t page_mask  = page_size - 1;
+
+        static std::size_t page_of(Entity entity) noexcept { return entity.index() >> page_shift; }
+        static std::size_t offset_of(Entity entity) noexcept { return entity.index() & page_mask; }
+
+        // get the sparse slot of an entity, allocates the page if it doesn't exist yet
+        Index& slot(Entity entity)
+        {
+            auto page = page_of(entity);
+
+            if (page >= m_sparse.size()) [[unlikely]] {
+                m_sparse.resize(page + 1);
+            }
+
+            auto& page_ptr = m_sparse[page];
+            if (page_ptr == nullptr) [[unlikely]] {
+                page_ptr = std::make_unique<Page>();
+                page_ptr->fill(null_index);
+            }
+
+            return (*page_ptr)[offset_of(entity)];
+        }
+
+        std::vector<std::unique_ptr<Page>> m_sparse;
+        std::vector<Entity>                m_dense;
+    };
+}
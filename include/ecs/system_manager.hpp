@@ -2,96 +2,469 @@
 
 #include "ecs/common.hpp"
 #include "ecs/concepts.hpp"
-#include "ecs/signature_mapper.hpp"
+#include "ecs/config.hpp"
+#include "ecs/profiler.hpp"
+#include "ecs/query_cache.hpp"
+#include "ecs/sparse_set.hpp"
+#include "ecs/thread_pool.hpp"
+#include "ecs/util/meta.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <memory>
-#include <ranges>
-#include <set>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace ecs
 {
-    template <concepts::Component... Comps>
+    template <typename Context>
     class SystemManager;
 
-    template <concepts::Component... Comps>
-    class Coordinator;
-
-    template <concepts::Component... Comps>
+    /**
+     * @brief Interface of a system.
+     *
+     * @tparam Context The coordinator the system is registered to.
+     */
+    template <typename Context>
     class ISystem
     {
     public:
-        virtual void update(
-            Coordinator<Comps...>&  context,
-            const std::set<Entity>& entities,
-            Duration                frame_time
-        ) = 0;
+        virtual void update(Context& context, std::span<const Entity> entities, Duration frame_time) = 0;
 
         virtual ~ISystem() = default;
+
+        /**
+         * @brief The change tick at the end of the previous run of the system, 0 before the first one.
+         *
+         * The components changed since then, by other systems or outside of them, have later ticks; the
+         * changes the system made itself don't. See `View::changed`.
+         */
+        Tick last_run() const { return m_last_run; }
+
+        // how long the previous run of the system took
+        Duration last_update_time() const { return m_last_update_time; }
+
+    private:
+        friend class SystemManager<Context>;
+
+        Tick     m_last_run         = 0;
+        Duration m_last_update_time = {};
     };
 
-    template <concepts::Component... Comps>
+    /**
+     * @brief Owns the systems and runs them every frame.
+     *
+     * Systems declare the components they read (const-qualified) and write (non-const) through their
+     * `Components` tuple, or through an `Access` tuple if they touch more than that. Two systems conflict if
+     * one of them writes a component the other accesses. Conflicting systems run in registration order
+     * unless ordered explicitly with `order`; the others run concurrently on a thread pool.
+     *
+     * The coordinator's change tick is advanced each time a system finishes. Systems running concurrently
+     * never write what the others access, so all the changes to the components a system accesses that are
+     * marked with a tick up to its `last_run` were seen by it.
+     */
+    template <typename Context>
     class SystemManager
     {
     public:
+        using ISystem = ecs::ISystem<Context>;
+
         SystemManager() = default;
 
-        template <typename System, typename... Args>
-            requires concepts::HasComponents<System>                 //
-                 and std::derived_from<System, ISystem<Comps...>>    //
+        /**
+         * @brief Create a system.
+         *
+         * @param populate Used to fill the system's entity set if no other system or view with the same
+         * signature exists yet, see `QueryCache::get`.
+         * @param args Arguments to construct the system with.
+         */
+        template <typename System, std::invocable<Signature, SparseSet&> Populate, typename... Args>
+            requires concepts::HasComponents<System>                //
+                 and std::derived_from<System, ISystem>             //
                  and std::constructible_from<System, Args...>
-        System& create_system(Args&&... args)
+        System& create_system(Populate&& populate, Args&&... args)
         {
-            m_entities.emplace_back();
+            using SigMapper  = typename Context::SigMapper;
+            using Components = util::TupleRemoveConst<typename System::Components>;
+            using Access     = typename AccessOf<System>::Type;
 
-            using SigMapper  = SignatureMapper<Comps...>;
-            auto  signature  = SigMapper::template map_tuple<typename System::Components>();
+            auto  signature  = SigMapper::template map_tuple<Components>();
+            auto& entities   = m_queries.get(signature, std::forward<Populate>(populate));
             auto  system     = std::make_unique<System>(std::forward<Args>(args)...);
             auto* system_ptr = system.get();
 
-            m_systems.emplace_back(signature, std::move(system));
+            m_systems.push_back({
+                .m_system      = std::move(system),
+                .m_entities    = &entities,
+                .m_reads       = access_signature<Access>(false),
+                .m_writes      = access_signature<Access>(true),
+                .m_main_thread = concepts::MainThreadSystem<System>,
+            });
+
+            build_schedule();
+            if constexpr (config::profile) {
+                m_profiler.add_system(util::type_name<System>());
+            }
 
             return *system_ptr;
         }
 
-        void entity_destroyed(Entity entity)
+        /**
+         * @brief Require a system to finish before another one starts.
+         *
+         * Explicit orders take precedence over the registration order of conflicting systems.
+         *
+         * @return False if the order would make a cycle with the previous ones, the schedule is left as is.
+         */
+        bool order(const ISystem& before, const ISystem& after)
         {
-            for (auto& entities : m_entities) {
-                entities.erase(entity);
+            auto before_index = index_of(before);
+            auto after_index  = index_of(after);
+
+            if (ordered_before(after_index, before_index)) {
+                return false;
             }
+
+            m_orders.emplace_back(before_index, after_index);
+            build_schedule();
+            return true;
+        }
+
+        /**
+         * @brief Get the entities that have at least the components in the signature.
+         *
+         * The set is shared with systems and other queries of the same signature.
+         */
+        template <std::invocable<Signature, SparseSet&> Populate>
+        const SparseSet& query(Signature signature, Populate&& populate)
+        {
+            return m_queries.get(signature, std::forward<Populate>(populate));
+        }
+
+        // refill the entity sets of the systems and queries, see `QueryCache::rebuild`
+        template <std::invocable<Signature, SparseSet&> Populate>
+        void rebuild_queries(Populate&& populate)
+        {
+            m_queries.rebuild(std::forward<Populate>(populate));
         }
 
+        void entity_destroyed(Entity entity) { m_queries.entity_destroyed(entity); }
+
+        void shrink_to_fit() { m_queries.shrink_to_fit(); }
+
         void entity_signature_changed(Entity entity, Signature entity_signature)
         {
-            for (auto i : std::views::iota(0uz, m_systems.size())) {
-                auto& [system_signature, system] = m_systems[i];
-                if (entity_signature.test(system_signature)) {
-                    m_entities[i].insert(entity);
-                } else {
-                    m_entities[i].erase(entity);
-                }
-            }
+            m_queries.entity_signature_changed(entity, entity_signature);
+        }
+
+        void entities_signature_changed(
+            std::span<const Entity>    entities,
+            std::span<const Signature> signatures
+        )
+        {
+            m_queries.entities_signature_changed(entities, signatures);
         }
 
-        void update(Coordinator<Comps...>& context, Duration frame_time)
+        void update(Context& context, ThreadPool& pool, Duration frame_time)
         {
-            for (auto i : std::views::iota(0uz, m_systems.size())) {
-                auto& [_, system] = m_systems[i];
-                auto& entities    = m_entities[i];
+            if constexpr (config::profile) {
+                m_profiler.begin_frame();
+            }
+
+            run_frame(Frame{ context, pool, frame_time });
 
-                system->update(context, entities, frame_time);
+            if constexpr (config::profile) {
+                m_profiler.end_frame();
             }
         }
 
-    private:
-        using ISystem = ISystem<Comps...>;
+        // the runs of the systems over the last frames, empty unless profiling is enabled
+        const Profiler& profiler() const { return recorded(m_profiler); }
 
+    private:
         struct SystemInfo
         {
-            Signature                m_signature;
             std::unique_ptr<ISystem> m_system;
+            const SparseSet*         m_entities;
+            Signature                m_reads;
+            Signature                m_writes;
+            bool                     m_main_thread;
         };
 
-        std::vector<SystemInfo>       m_systems;
-        std::vector<std::set<Entity>> m_entities;
+        // takes no space and records nothing unless profiling is enabled
+        using MaybeProfiler = std::conditional_t<config::profile, Profiler, NoProfiler>;
+
+        static const Profiler& recorded(const Profiler& profiler) { return profiler; }
+
+        static const Profiler& recorded(const NoProfiler&)
+        {
+            static const auto empty = Profiler{};
+            return empty;
+        }
+
+        // bookkeeping of a frame being run in parallel
+        struct State
+        {
+            std::unique_ptr<std::atomic<std::size_t>[]> m_remaining;    // unfinished predecessors
+            std::atomic<std::size_t>                    m_pending;      // unfinished systems
+            std::vector<std::size_t>                    m_main_thread_queue;
+            std::mutex                                  m_main_thread_mutex;
+        };
+
+        struct Frame
+        {
+            Context&    m_context;
+            ThreadPool& m_pool;
+            Duration    m_frame_time;
+        };
+
+        void run_frame(const Frame& frame)
+        {
+            if (frame.m_pool.size() == 0 or m_systems.size() < 2) {
+                for (auto index : m_serial_order) {
+                    run_system(frame, index);
+                }
+                return;
+            }
+
+            auto& state = *m_state;
+            for (auto i = 0uz; i < m_systems.size(); ++i) {
+                state.m_remaining[i].store(m_predecessors[i], std::memory_order_relaxed);
+            }
+            state.m_pending.store(m_systems.size(), std::memory_order_relaxed);
+
+            for (auto i = 0uz; i < m_systems.size(); ++i) {
+                if (m_predecessors[i] == 0) {
+                    dispatch(frame, i);
+                }
+            }
+
+            // the calling thread runs the main thread systems and helps the pool with the rest
+            while (state.m_pending.load(std::memory_order_acquire) != 0) {
+                if (auto index = pop_main_thread_system()) {
+                    run(frame, *index);
+                } else if (not frame.m_pool.run_pending()) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        template <typename System>
+        struct AccessOf
+        {
+            using Type = typename System::Components;
+        };
+
+        template <concepts::HasAccess System>
+        struct AccessOf<System>
+        {
+            using Type = typename System::Access;
+        };
+
+        // signature of the components accessed, or only of the written (non-const) ones
+        template <concepts::ComponentAccessTuple Access>
+        static Signature access_signature(bool writes_only)
+        {
+            using SigMapper = typename Context::SigMapper;
+
+            auto handler = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                auto signature = Signature{};
+                auto add       = [&]<typename Comp>() {
+                    // tags have no value, so they are never written
+                    auto writes = not std::is_const_v<Comp> and not concepts::Tag<std::remove_const_t<Comp>>;
+                    if (not writes_only or writes) {
+                        signature.set(SigMapper::template map<std::remove_const_t<Comp>>());
+                    }
+                };
+                (add.template operator()<std::tuple_element_t<Is, Access>>(), ...);
+                return signature;
+            };
+            return handler(std::make_index_sequence<std::tuple_size_v<Access>>{});
+        }
+
+        bool conflicts(const SystemInfo& lhs, const SystemInfo& rhs) const
+        {
+            auto lhs_writes = (lhs.m_writes & (rhs.m_reads | rhs.m_writes)) != Signature{};
+            auto rhs_writes = (rhs.m_writes & (lhs.m_reads | lhs.m_writes)) != Signature{};
+            return lhs_writes or rhs_writes;
+        }
+
+        std::size_t index_of(const ISystem& system) const
+        {
+            auto system_of = [](const SystemInfo& info) { return info.m_system.get(); };
+            auto found     = std::ranges::find(m_systems, &system, system_of);
+            assert(found != m_systems.end() and "System is not registered to this manager");
+            return static_cast<std::size_t>(found - m_systems.begin());
+        }
+
+        // whether the explicit orders require system `from` to run before system `to`, or they are the same
+        bool ordered_before(std::size_t from, std::size_t to) const
+        {
+            auto visited = std::vector<bool>(m_systems.size(), false);
+            auto pending = std::vector<std::size_t>{ from };
+
+            while (not pending.empty()) {
+                auto current = pending.back();
+                pending.pop_back();
+
+                if (current == to) {
+                    return true;
+                }
+                if (visited[current]) {
+                    continue;
+                }
+                visited[current] = true;
+
+                for (auto [before, after] : m_orders) {
+                    if (before == current) {
+                        pending.push_back(after);
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        // rebuild the dependency graph from the explicit orders and the conflicts between systems
+        void build_schedule()
+        {
+            auto count = m_systems.size();
+
+            // reach[i][j] is true if system i is ordered before system j
+            auto reach = std::vector<std::vector<bool>>(count, std::vector<bool>(count, false));
+
+            m_successors.assign(count, {});
+            m_predecessors.assign(count, 0);
+
+            auto add_edge = [&](std::size_t from, std::size_t to) {
+                for (auto i = 0uz; i < count; ++i) {
+                    if (i != from and not reach[i][from]) {
+                        continue;
+                    }
+                    reach[i][to] = true;
+                    for (auto j = 0uz; j < count; ++j) {
+                        reach[i][j] = reach[i][j] or reach[to][j];
+                    }
+                }
+                m_successors[from].push_back(to);
+                ++m_predecessors[to];
+            };
+
+            for (auto [before, after] : m_orders) {
+                assert(before != after and not reach[after][before] and "Cyclic system order");
+                if (not reach[before][after]) {
+                    add_edge(before, after);
+                }
+            }
+
+            for (auto i = 0uz; i < count; ++i) {
+                for (auto j = i + 1; j < count; ++j) {
+                    if (conflicts(m_systems[i], m_systems[j]) and not reach[i][j] and not reach[j][i]) {
+                        add_edge(i, j);
+                    }
+                }
+            }
+
+            // topological order for running serially
+            auto remaining = m_predecessors;
+            m_serial_order.clear();
+            for (auto i = 0uz; i < count; ++i) {
+                if (remaining[i] == 0) {
+                    m_serial_order.push_back(i);
+                }
+            }
+            for (auto i = 0uz; i < m_serial_order.size(); ++i) {
+                for (auto next : m_successors[m_serial_order[i]]) {
+                    if (--remaining[next] == 0) {
+                        m_serial_order.push_back(next);
+                    }
+                }
+            }
+
+            m_state              = std::make_unique<State>();
+            m_state->m_remaining = std::make_unique<std::atomic<std::size_t>[]>(count);
+        }
+
+        void run_system(const Frame& frame, std::size_t index)
+        {
+            auto& info = m_systems[index];
+
+            auto start = Clock::now();
+            {
+                auto attribution = Profiler::Attribution{ m_profiler.begin_run(index) };
+                info.m_system->update(frame.m_context, info.m_entities->entities(), frame.m_frame_time);
+            }
+            auto end = Clock::now();
+
+            if constexpr (config::profile) {
+                m_profiler.record(
+                    index,
+                    {
+                        .m_start    = start,
+                        .m_end      = end,
+                        .m_thread   = Profiler::thread_index(),
+                        .m_entities = static_cast<std::uint32_t>(info.m_entities->size()),
+                    }
+                );
+            }
+
+            info.m_system->m_last_update_time = end - start;
+            info.m_system->m_last_run         = frame.m_context.advance_change_tick();
+        }
+
+        void run(Frame frame, std::size_t index)
+        {
+            run_system(frame, index);
+
+            for (auto next : m_successors[index]) {
+                if (m_state->m_remaining[next].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    dispatch(frame, next);
+                }
+            }
+
+            m_state->m_pending.fetch_sub(1, std::memory_order_release);
+        }
+
+        void dispatch(Frame frame, std::size_t index)
+        {
+            if (m_systems[index].m_main_thread) {
+                auto lock = std::scoped_lock{ m_state->m_main_thread_mutex };
+                m_state->m_main_thread_queue.push_back(index);
+            } else {
+                frame.m_pool.submit([this, frame, index] { run(frame, index); });
+            }
+        }
+
+        std::optional<std::size_t> pop_main_thread_system()
+        {
+            auto lock = std::scoped_lock{ m_state->m_main_thread_mutex };
+            if (m_state->m_main_thread_queue.empty()) {
+                return std::nullopt;
+            }
+
+            auto index = m_state->m_main_thread_queue.back();
+            m_state->m_main_thread_queue.pop_back();
+
+            return index;
+        }
+
+        std::vector<SystemInfo> m_systems;
+        QueryCache              m_queries;
+
+        [[no_unique_address]] MaybeProfiler m_profiler;
+
+        // dependency graph
+        std::vector<std::pair<std::size_t, std::size_t>> m_orders;
+        std::vector<std::vector<std::size_t>>            m_successors;
+        std::vector<std::size_t>                         m_predecessors;
+        std::vector<std::size_t>                         m_serial_order;
+        std::unique_ptr<State>                           m_state;
     };
 }
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <type_traits>
+
+namespace ecs
+{
+    /**
+     * @brief Whether a component is a tag: a marker that only says whether an entity has it.
+     *
+     * Empty types are tags by default. Specialize this to `std::true_type` to treat a non-empty type as a
+     * tag, its value is then never stored and retrieving it yields a default constructed instance.
+     */
+    template <typename T>
+    struct IsTag : std::bool_constant<std::is_empty_v<T>>
+    {
+    };
+
+    // tags have no per-entity storage, retrieving one yields this instance
+    template <typename T>
+        requires IsTag<T>::value
+    inline const T tag_instance = T{};
+}
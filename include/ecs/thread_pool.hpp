@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace ecs
+{
+    /**
+     * @brief A fixed-size work-stealing pool of worker threads executing submitted tasks.
+     *
+     * Each worker owns a task queue. Tasks submitted from a worker go to its own queue and are executed
+     * most recent first while they are still hot in cache; an idle worker steals the oldest task of another
+     * queue. Tasks submitted from other threads are spread over the queues.
+     *
+     * The thread that waits for tasks to finish is expected to help executing them (see `run_pending`), so
+     * the default pool size leaves one hardware thread for it.
+     */
+    class ThreadPool
+    {
+    public:
+        using Task = std::move_only_function<void()>;
+
+        static std::size_t default_thread_count()
+        {
+            auto hardware = static_cast<std::size_t>(std::thread::hardware_concurrency());
+            return std::max(hardware, 1uz) - 1;
+        }
+
+        explicit ThreadPool(std::size_t thread_count = default_thread_count())
+        {
+            // a pool without workers still queues tasks for the threads that help
+            m_queues.resize(std::max(thread_count, 1uz));
+            for (auto& queue : m_queues) {
+                queue = std::make_unique<Queue>();
+            }
+
+            m_workers.reserve(thread_count);
+            for (auto i = 0uz; i < thread_count; ++i) {
+                m_workers.emplace_back([this, i](std::stop_token stop) { work(stop, i); });
+            }
+        }
+
+        ThreadPool(ThreadPool&&)            = delete;
+        ThreadPool& operator=(ThreadPool&&) = delete;
+
+        ~ThreadPool()
+        {
+            for (auto& worker : m_workers) {
+                worker.request_stop();
+            }
+            m_condition.notify_all();
+        }
+
+        // number of worker threads, not counting the threads that help while waiting
+        std::size_t size() const noexcept { return m_workers.size(); }
+
+        void submit(Task task)
+        {
+            auto index = s_pool == this ? s_index : m_next.fetch_add(1, std::memory_order_relaxed);
+            index      = index % m_queues.size();
+            {
+                auto& queue = *m_queues[index];
+                auto  lock  = std::scoped_lock{ queue.m_mutex };
+                queue.m_tasks.push_back(std::move(task));
+            }
+            {
+                // published under the sleep mutex so a worker about to sleep can't miss it
+                auto lock = std::scoped_lock{ m_sleep_mutex };
+                m_queued.fetch_add(1, std::memory_order_release);
+            }
+            m_condition.notify_one();
+        }
+
+        /**
+         * @brief Execute one queued task on the calling thread, if there is any.
+         *
+         * @return Whether a task was executed.
+         */
+        bool run_pending()
+        {
+            auto task = s_pool == this ? take(s_index) : steal(0);
+            if (not task) {
+                return false;
+            }
+
+            (*task)();
+            return true;
+        }
+
+        /**
+         * @brief Block until the counter reaches zero while helping to execute queued tasks.
+         */
+        void wait(const std::atomic<std::size_t>& pending)
+        {
+            while (pending.load(std::memory_order_acquire) != 0) {
+                if (not run_pending()) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        /**
+         * @brief Invoke `fn(begin, end)` over consecutive chunks of `[0, count)` in parallel.
+         *
+         * The chunks are claimed dynamically by the calling thread and up to `size()` workers, so uneven
+         * chunks balance out. Returns once every chunk has been processed.
+         *
+         * @param count The size of the range.
+         * @param chunk_size The size of each chunk, except possibly the last one.
+         * @param fn The function to invoke, must be safe to call concurrently on disjoint chunks.
+         */
+        template <std::invocable<std::size_t, std::size_t> Fn>
+        void parallel_for(std::size_t count, std::size_t chunk_size, Fn&& fn)
+        {
+            chunk_size  = std::max(chunk_size, 1uz);
+            auto chunks = (count + chunk_size - 1) / chunk_size;
+
+            if (chunks <= 1 or m_workers.empty()) {
+                fn(0uz, count);
+                return;
+            }
+
+            auto next    = std::atomic<std::size_t>{ 0 };
+            auto process = [&] {
+                for (auto chunk = next.fetch_add(1); chunk < chunks; chunk = next.fetch_add(1)) {
+                    auto begin = chunk * chunk_size;
+                    fn(begin, std::min(begin + chunk_size, count));
+                }
+            };
+
+            auto helpers = std::min(chunks - 1, m_workers.size());
+            auto pending = std::atomic<std::size_t>{ helpers };
+
+            for (auto i = 0uz; i < helpers; ++i) {
+                submit([&] {
+                    process();
+                    pending.fetch_sub(1, std::memory_order_release);
+                });
+            }
+
+            process();
+            wait(pending);
+        }
+
+    private:
+        struct Queue
+        {
+            std::mutex       m_mutex;
+            std::deque<Task> m_tasks;
+        };
+
+        // take the newest task of the own queue, or steal from the others
+        std::optional<Task> take(std::size_t index)
+        {
+            auto& queue = *m_queues[index];
+            {
+                auto lock = std::scoped_lock{ queue.m_mutex };
+                if (not queue.m_tasks.empty()) {
+                    auto task = std::move(queue.m_tasks.back());
+                    queue.m_tasks.pop_back();
+                    m_queued.fetch_sub(1, std::memory_order_relaxed);
+                    return task;
+                }
+            }
+            return steal(index + 1);
+        }
+
+        // take the oldest task of the first non-empty queue, starting from the given one
+        std::optional<Task> steal(std::size_t start)
+        {
+            if (m_queued.load(std::memory_order_acquire) == 0) {
+                return std::nullopt;
+            }
+
+            for (auto i = 0uz; i < m_queues.size(); ++i) {
+                auto& queue = *m_queues[(start + i) % m_queues.size()];
+                auto  lock  = std::scoped_lock{ queue.m_mutex };
+                if (not queue.m_tasks.empty()) {
+                    auto task = std::move(queue.m_tasks.front());
+                    queue.m_tasks.pop_front();
+                    m_queued.fetch_sub(1, std::memory_order_relaxed);
+                    return task;
+                }
+            }
+            return std::nullopt;
+        }
+
+        void work(std::stop_token stop, std::size_t index)
+        {
+            s_pool  = this;
+            s_index = index;
+
+            while (not stop.stop_requested()) {
+                if (auto task = take(index)) {
+                    (*task)();
+                    continue;
+                }
+
+                auto lock = std::unique_lock{ m_sleep_mutex };
+                m_condition.wait(lock, stop, [&] { return m_queued.load(std::memory_order_acquire) != 0; });
+            }
+        }
+
+        // the pool the current thread is a worker of, and its index there
+        static inline thread_local ThreadPool* s_pool  = nullptr;
+        static inline thread_local std::size_t s_index = 0;
+
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::atomic<std::size_t>            m_queued = 0;
+        std::atomic<std::size_t>            m_next   = 0;
+        std::mutex                          m_sleep_mutex;
+        std::condition_variable_any         m_condition;
+        std::vector<std::jthread>           m_workers;
+    };
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#if __has_include(<sys/mman.h>) and __has_include(<unistd.h>)
+#    define SIMPLE_ECS_MMAP 1
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#else
+#    define SIMPLE_ECS_MMAP 0
+#endif
+
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <new>
+#include <span>
+#include <system_error>
+
+namespace ecs::util
+{
+    /**
+     * @brief A whole file mapped into memory privately.
+     *
+     * Where POSIX `mmap` is available the pages are read from the file on first access, and writing to them
+     * makes a copy of the page for the process, the file itself is never modified. The file must not be
+     * truncated while it is mapped. Elsewhere the whole file is read into memory aligned like a page.
+     */
+    class MappedFile
+    {
+    public:
+        // alignment of the bytes, at least the one of a page where the file is actually mapped
+        static constexpr std::size_t alignment = 4096;
+
+        // null if the file can't be opened or is empty
+        static std::shared_ptr<MappedFile> open(const std::filesystem::path& path)
+        {
+#if SIMPLE_ECS_MMAP
+            auto fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                return nullptr;
+            }
+
+            struct stat info = {};
+            if (::fstat(fd, &info) != 0 or info.st_size <= 0) {
+                ::close(fd);
+                return nullptr;
+            }
+
+            auto  size    = static_cast<std::size_t>(info.st_size);
+            auto* address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            ::close(fd);    // the mapping keeps the file alive
+
+            if (address == MAP_FAILED) {
+                return nullptr;
+            }
+
+            return std::shared_ptr<MappedFile>{ new MappedFile{ static_cast<std::byte*>(address), size } };
+#else
+            auto error = std::error_code{};
+            auto size  = static_cast<std::size_t>(std::filesystem::file_size(path, error));
+            if (error or size == 0) {
+                return nullptr;
+            }
+
+            auto* file = std::fopen(path.string().c_str(), "rb");
+            if (file == nullptr) {
+                return nullptr;
+            }
+
+            auto* data = static_cast<std::byte*>(::operator new(size, std::align_val_t{ alignment }));
+            auto  read = std::fread(data, 1, size, file);
+            std::fclose(file);
+
+            if (read != size) {
+                ::operator delete(data, std::align_val_t{ alignment });
+                return nullptr;
+            }
+
+            return std::shared_ptr<MappedFile>{ new MappedFile{ data, size } };
+#endif
+        }
+
+        ~MappedFile()
+        {
+#if SIMPLE_ECS_MMAP
+            ::munmap(m_data, m_size);
+#else
+            ::operator delete(m_data, std::align_val_t{ alignment });
+#endif
+        }
+
+        MappedFile(MappedFile&&)            = delete;
+        MappedFile& operator=(MappedFile&&) = delete;
+
+        std::span<std::byte> bytes() const noexcept { return { m_data, m_size }; }
+
+    private:
+        MappedFile(std::byte* data, std::size_t size)
+            : m_data{ data }
+            , m_size{ size }
+        {
+        }
+
+        std::byte*  m_data;
+        std::size_t m_size;
+    };
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+
+namespace ecs::util
+{
+    // deletes what it was given unless it was told that the memory is borrowed
+    template <typename T>
+    struct MaybeOwnedDelete
+    {
+        bool m_owned = true;
+
+        void operator()(std::remove_extent_t<T>* pointer) const
+        {
+            if (m_owned) {
+                std::default_delete<T>{}(pointer);
+            }
+        }
+    };
+
+    /**
+     * @brief A unique pointer that may point to memory owned by someone else, e.g. a mapped file.
+     *
+     * Whoever borrows the memory is responsible for keeping its owner alive for as long as the pointer is.
+     */
+    template <typename T>
+    using MaybeOwned = std::unique_ptr<T, MaybeOwnedDelete<T>>;
+
+    template <typename T>
+    MaybeOwned<T> own(std::unique_ptr<T>&& pointer)
+    {
+        return MaybeOwned<T>{ pointer.release() };
+    }
+
+    template <typename T>
+    MaybeOwned<T> borrow(std::remove_extent_t<T>* pointer)
+    {
+        return MaybeOwned<T>{ pointer, MaybeOwnedDelete<T>{ false } };
+    }
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string_view>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -47,6 +48,18 @@ namespace ecs::util::detail
     {
     };
 
+    template <typename>
+    struct TupleRemoveConstImpl
+    {
+        static_assert(false, "not a tuple");
+    };
+
+    template <typename... Ts>
+    struct TupleRemoveConstImpl<std::tuple<Ts...>>
+    {
+        using Type = std::tuple<std::remove_const_t<Ts>...>;
+    };
+
     template <typename, typename>
     struct TupleCatUniqImpl
     {
@@ -121,6 +134,9 @@ namespace ecs::util
     template <typename Tuple1, typename Tuple2>
     using TupleCatUniq = typename detail::TupleCatUniqImpl<Tuple1, Tuple2>::Type;
 
+    template <typename Tuple>
+    using TupleRemoveConst = typename detail::TupleRemoveConstImpl<Tuple>::Type;
+
     template <typename Tuple1, typename Tuple2>
     static constexpr bool subset_of_tuple()
     {
@@ -133,4 +149,15 @@ namespace ecs::util
 
         return handler(std::make_index_sequence<Traits1::size>{});
     }
+
+    // the name of a type as spelled by the compiler, e.g. `nexus::PhysicsSystem`
+    template <typename T>
+    constexpr std::string_view type_name()
+    {
+        // GCC: "... type_name() [with T = Name; ...]", clang: "... type_name() [T = Name]"
+        auto function = std::string_view{ __PRETTY_FUNCTION__ };
+        auto start    = function.find("T = ") + 4;
+        auto end      = function.find_first_of(";]", start);
+        return function.substr(start, end - start);
+    }
 }
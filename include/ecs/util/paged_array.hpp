@@ -0,0 +1,113 @@
+#pragma once
+
+#include "ecs/util/common.hpp"
+#include "ecs/util/maybe_owned.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace ecs::util
+{
+    /**
+     * @brief An array that grows in fixed-size pages allocated on demand.
+     *
+     * Growing never moves the elements already stored, and the pages past a given size can be released
+     * back to the allocator. The elements of a new page are default-initialized, so they are left
+     * uninitialized for trivially default constructible types. The pages can also be adopted from memory
+     * owned by something else, e.g. a snapshot mapped into memory.
+     *
+     * @tparam T Types to be stored inside the array.
+     * @tparam PageSize Number of elements per page, must be a power of two.
+     */
+    template <typename T, std::size_t PageSize>
+        requires std::default_initializable<T> and std::copyable<T>
+    class PagedArray
+    {
+    public:
+        static constexpr std::size_t page_size = PageSize;
+
+        static_assert(std::has_single_bit(page_size), "Page size must be a power of two");
+
+        PagedArray() = default;
+
+        explicit PagedArray(std::size_t capacity) { reserve(capacity); }
+
+        template <typename Self>
+        auto&& operator[](this Self&& self, std::size_t index) noexcept
+        {
+            assert(index < self.capacity() and "Index out of range");
+            auto&& page = std::forward<Self>(self).m_pages[index >> page_shift];
+            return util::index<T>(page, index & page_mask);
+        }
+
+        std::size_t capacity() const noexcept { return m_pages.size() * page_size; }
+        std::size_t page_count() const noexcept { return m_pages.size(); }
+
+        // allocate pages until the array can hold `capacity` elements
+        void reserve(std::size_t capacity)
+        {
+            auto pages = (capacity + page_size - 1) >> page_shift;
+            while (m_pages.size() < pages) {
+                m_pages.push_back(util::own(std::make_unique_for_overwrite<T[]>(page_size)));
+            }
+        }
+
+        // release the pages not needed to hold the first `size` elements
+        void shrink(std::size_t size)
+        {
+            auto pages = (size + page_size - 1) >> page_shift;
+            if (pages < m_pages.size()) {
+                m_pages.resize(pages);
+                m_pages.shrink_to_fit();
+            }
+        }
+
+        /**
+         * @brief Get the elements from an index up to a count or the end of its page, whichever is first.
+         *
+         * The elements of a page are contiguous, so a range of the array can be processed as a few spans.
+         */
+        template <typename Self>
+        auto run(this Self&& self, std::size_t index, std::size_t count) noexcept
+        {
+            assert(index < self.capacity() and "Index out of range");
+
+            auto offset = index & page_mask;
+            auto length = std::min(count, page_size - offset);
+            auto* first = &std::forward<Self>(self)[index];
+
+            return std::span{ first, length };
+        }
+
+        /**
+         * @brief Replace the pages with ones borrowed from contiguous memory, without copying.
+         *
+         * @param elements Whole pages of elements, the array uses them in place.
+         * @param owner Kept alive for as long as the array, it owns the memory of `elements`.
+         */
+        void adopt(std::span<T> elements, std::shared_ptr<const void> owner)
+        {
+            assert(elements.size() % page_size == 0 and "Only whole pages can be adopted");
+
+            m_pages.clear();
+            m_pages.reserve(elements.size() >> page_shift);
+
+            for (auto first = 0uz; first < elements.size(); first += page_size) {
+                m_pages.push_back(util::borrow<T[]>(elements.data() + first));
+            }
+            m_owner = std::move(owner);
+        }
+
+    private:
+        static constexpr std::size_t page_shift = std::countr_zero(page_size);
+        static constexpr std::size_t page_mask  = page_size - 1;
+
+        std::vector<util::MaybeOwned<T[]>> m_pages;
+        std::shared_ptr<const void>        m_owner;    // of the adopted pages
+    };
+}
@@ -0,0 +1,268 @@
+#pragma once
+
+#include "ecs/common.hpp"
+#include "ecs/component_slot.hpp"
+#include "ecs/concepts.hpp"
+#include "ecs/config.hpp"
+#include "ecs/soa.hpp"
+#include "ecs/sparse_set.hpp"
+#include "ecs/util/concepts.hpp"
+#include "ecs/util/meta.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ecs
+{
+    /**
+     * @brief A view over the entities that have a set of components.
+     *
+     * The view lets the storage walk its own columns and yields references to the components directly, no
+     * entity is looked up again: `ArchetypeManager` goes chunk by chunk through the archetypes that have the
+     * components, and `ComponentManager` follows the dense array of a component only the viewed entities
+     * have, if any. The entities thus come in the storage's order rather than the one of `entities`, the
+     * set cached by the coordinator for the view's signature.
+     *
+     * A const-qualified component yields a const reference, and so does a tag since it has no per-entity
+     * value to write to. A component with a structure-of-arrays layout yields a `SoaRef` proxy.
+     *
+     * A view can be narrowed down to the entities whose components changed or were added after a tick with
+     * `changed` and `added`, e.g. to the last run of the system. The filtered out entities are still walked
+     * over, but only their ticks are read; `size`, `empty`, and `entities` ignore the filters.
+     *
+     * Adding or removing components of the viewed signature while iterating invalidates the iteration, and
+     * the iterators of a view must not outlive it.
+     *
+     * @tparam Context The coordinator type.
+     * @tparam Comps The components to yield, may be const-qualified.
+     */
+    template <typename Context, typename... Comps>
+        requires (concepts::Component<std::remove_const_t<Comps>> and ...)
+    class View
+    {
+    public:
+        template <typename Comp>
+        using Ref = std::conditional_t<
+            concepts::SoaComponent<std::remove_const_t<Comp>>,
+            SoaRef<Comp>,
+            std::conditional_t<concepts::Tag<std::remove_const_t<Comp>>, const Comp&, Comp&>>;
+
+        using Tuple  = std::tuple<Ref<Comps>...>;
+        using Cursor = typename Context::template Cursor<std::remove_const_t<Comps>...>;
+
+        class Iterator
+        {
+        public:
+            using value_type      = Tuple;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+
+            Iterator(const View* view, std::size_t position)
+                : m_view{ view }
+                , m_cursor{ view->cursor(position) }
+            {
+                skip();
+            }
+
+            Tuple operator*() const
+            {
+                auto tick  = m_view->m_context->change_tick();
+                auto yield = [&](const auto&... slots) { return View::yield(tick, slots...); };
+                return std::apply(yield, m_cursor.slots());
+            }
+
+            // clang-format off
+            Iterator& operator++()    { m_cursor.advance(); skip(); return *this; }
+            Iterator  operator++(int) { auto copy = *this; ++*this; return copy; }
+            // clang-format on
+
+            bool operator==(const Iterator& other) const
+            {
+                return m_cursor.position() == other.m_cursor.position();
+            }
+
+            Entity entity() const { return m_cursor.entity(); }
+
+        private:
+            // move past the entities the filters reject
+            void skip()
+            {
+                if (not m_view->m_filtered) {
+                    return;
+                }
+
+                auto accepts = [&](const auto&... slots) { return m_view->accepts(slots...); };
+                while (m_cursor.position() != m_view->size() and not std::apply(accepts, m_cursor.slots())) {
+                    m_cursor.advance();
+                }
+            }
+
+            const View* m_view = nullptr;
+            Cursor      m_cursor;
+        };
+
+        View(Context& context, const SparseSet& entities)
+            : m_context{ &context }
+            , m_entities{ &entities }
+        {
+        }
+
+        Iterator begin() const { return { this, 0 }; }
+        Iterator end() const { return { this, size() }; }
+
+        std::size_t size() const { return m_entities->size(); }
+        bool        empty() const { return m_entities->empty(); }
+
+        std::span<const Entity> entities() const { return m_entities->entities(); }
+
+        /**
+         * @brief Only yield the entities whose component was changed, or added, after a tick.
+         *
+         * Getting a component mutably counts as changing it. Filters on several components must all pass.
+         *
+         * @tparam Comp One of the components of the view, not a tag.
+         * @param since Usually the `last_run` of the system iterating the view.
+         */
+        template <typename Comp>
+            requires util::OneOf<std::remove_const_t<Comp>, std::remove_const_t<Comps>...>
+                 and (not concepts::Tag<std::remove_const_t<Comp>>)
+        View changed(Tick since) const
+        {
+            auto view = *this;
+            view.m_changed_since[index_of<Comp>()] = since;
+            view.m_filtered                        = true;
+            return view;
+        }
+
+        // only yield the entities whose component was added after a tick, see `changed`
+        template <typename Comp>
+            requires util::OneOf<std::remove_const_t<Comp>, std::remove_const_t<Comps>...>
+                 and (not concepts::Tag<std::remove_const_t<Comp>>)
+        View added(Tick since) const
+        {
+            auto view = *this;
+            view.m_added_since[index_of<Comp>()] = since;
+            view.m_filtered                      = true;
+            return view;
+        }
+
+        /**
+         * @brief Invoke a function for each entity in the view.
+         *
+         * @param fn Invoked as either `fn(entity, comps...)` or `fn(comps...)`.
+         */
+        template <typename Fn>
+            requires std::invocable<Fn&, Entity, Ref<Comps>...> or std::invocable<Fn&, Ref<Comps>...>
+        void each(Fn&& fn) const
+        {
+            visit(0, size(), fn, m_context->change_tick());
+        }
+
+        /**
+         * @brief Invoke a function for each entity in the view, splitting the entities across threads.
+         *
+         * The function is invoked concurrently, so it must only write to the components it is given or to
+         * otherwise disjoint memory. Runs serially if the view has less entities than the threshold.
+         *
+         * @param fn Invoked as either `fn(entity, comps...)` or `fn(comps...)`.
+         * @param threshold Minimum number of entities for the iteration to be split.
+         */
+        template <typename Fn>
+            requires std::invocable<Fn&, Entity, Ref<Comps>...> or std::invocable<Fn&, Ref<Comps>...>
+        void par_each(Fn&& fn, std::size_t threshold = config::parallel_threshold) const
+        {
+            auto tick    = m_context->change_tick();
+            auto process = [&](std::size_t begin, std::size_t end) { visit(begin, end, fn, tick); };
+            m_context->par_for(size(), process, threshold);
+        }
+
+    private:
+        using Traits = util::PackTraits<std::remove_const_t<Comps>...>;
+
+        template <typename Comp>
+        static constexpr std::size_t index_of()
+        {
+            return Traits::template index<std::remove_const_t<Comp>>();
+        }
+
+        Cursor cursor(std::size_t position) const
+        {
+            return m_context->template cursor<std::remove_const_t<Comps>...>(*m_entities, position);
+        }
+
+        // invoke `fn` for the entities in `[begin, end)` of the storage's order that pass the filters,
+        // marking the mutable components as changed at `tick`
+        template <typename Fn>
+        void visit(std::size_t begin, std::size_t end, Fn& fn, Tick tick) const
+        {
+            auto invoke = [&](Entity entity, ComponentSlot<std::remove_const_t<Comps>>... slots) {
+                if (m_filtered and not accepts(slots...)) {
+                    return;
+                }
+
+                (mark_changed<Comps>(slots, tick), ...);
+
+                if constexpr (std::invocable<Fn&, Entity, Ref<Comps>...>) {
+                    fn(entity, Ref<Comps>(slots.m_ref)...);
+                } else {
+                    fn(Ref<Comps>(slots.m_ref)...);
+                }
+            };
+            m_context->template for_each_in<std::remove_const_t<Comps>...>(*m_entities, begin, end, invoke);
+        }
+
+        bool accepts(const ComponentSlot<std::remove_const_t<Comps>>&... slots) const
+        {
+            auto handler = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                return (accepts<Is>(slots) and ...);
+            };
+            return handler(std::index_sequence_for<Comps...>{});
+        }
+
+        template <std::size_t I, typename Comp>
+        bool accepts(const ComponentSlot<Comp>& slot) const
+        {
+            if constexpr (concepts::Tag<Comp>) {
+                return true;
+            } else {
+                const auto& changed = m_changed_since[I];
+                const auto& added   = m_added_since[I];
+
+                return (not changed or slot.m_ticks->changed_since(*changed))
+                   and (not added or slot.m_ticks->added_since(*added));
+            }
+        }
+
+        // getting a component mutably counts as changing it
+        template <typename Comp>
+        static void mark_changed(const ComponentSlot<std::remove_const_t<Comp>>& slot, Tick tick)
+        {
+            if constexpr (not std::is_const_v<Comp> and not concepts::Tag<std::remove_const_t<Comp>>) {
+                slot.m_ticks->m_changed = tick;
+            }
+        }
+
+        // the references to yield for an entity, marking the mutable components as changed at `tick`
+        static Tuple yield(Tick tick, const ComponentSlot<std::remove_const_t<Comps>>&... slots)
+        {
+            (mark_changed<Comps>(slots, tick), ...);
+            return { Ref<Comps>(slots.m_ref)... };
+        }
+
+        Context*         m_context;
+        const SparseSet* m_entities;
+
+        // indexed like the components, the tick each one must have changed or been added after if any
+        std::array<std::optional<Tick>, sizeof...(Comps)> m_changed_since = {};
+        std::array<std::optional<Tick>, sizeof...(Comps)> m_added_since   = {};
+        bool                                              m_filtered      = false;
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ecs/concepts.hpp>
+#include <ecs/soa.hpp>
 
 #include <glm/vec3.hpp>
 
@@ -15,3 +16,12 @@ namespace nexus
 
     static_assert(ecs::concepts::Component<RigidBody>);
 }
+
+template <>
+struct ecs::SoaLayout<nexus::RigidBody>
+    : ecs::SoaFields<
+          &nexus::RigidBody::m_velocity,
+          &nexus::RigidBody::m_acceleration,
+          &nexus::RigidBody::m_angular_velocity>
+{
+};
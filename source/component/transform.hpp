@@ -1,6 +1,8 @@
 #pragma once
 
 #include <ecs/concepts.hpp>
+#include <ecs/quantize.hpp>
+#include <ecs/soa.hpp>
 
 #include <glm/vec3.hpp>
 #include <glm/ext/quaternion_float.hpp>
@@ -16,3 +18,17 @@ namespace nexus
 
     static_assert(ecs::concepts::Component<Transform>);
 }
+
+// physics only integrates the position and rotation, so the scale is kept out of its way
+template <>
+struct ecs::SoaLayout<nexus::Transform>
+    : ecs::SoaFields<&nexus::Transform::m_position, &nexus::Transform::m_scale, &nexus::Transform::m_rotation>
+{
+};
+
+// observers only draw it, a thousandth of a unit and of a quaternion component is plenty
+template <>
+struct ecs::Quantize<nexus::Transform>
+{
+    static constexpr float step = 1.0f / 1024.0f;
+};
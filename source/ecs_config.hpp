@@ -8,17 +8,28 @@
 #include "component/thrust.hpp"
 #include "component/transform.hpp"
 
-#include <ecs/component_manager.hpp>
+#include <ecs/coordinator.hpp>
 #include <ecs/system_manager.hpp>
 
+#include <string_view>
+
 namespace nexus::ecs_config
 {
 #define NEXUS_COMPONENTS Camera, Gravity, Player, Renderable, RigidBody, Thrust, Transform
 
-    using ComponentManager = ecs::ComponentManager<NEXUS_COMPONENTS>;
-    using SystemManager    = ecs::SystemManager<NEXUS_COMPONENTS>;
-    using ISystem          = ecs::ISystem<NEXUS_COMPONENTS>;
-    using Coordinator      = ecs::Coordinator<NEXUS_COMPONENTS>;
+#ifdef NEXUS_ARCHETYPE_STORAGE
+    using Coordinator = ecs::ArchetypeCoordinator<NEXUS_COMPONENTS>;
+
+    constexpr std::string_view storage_name = "archetype";
+#else
+    using Coordinator = ecs::Coordinator<NEXUS_COMPONENTS>;
+
+    constexpr std::string_view storage_name = "sparse_set";
+#endif
+
+    using ComponentManager = Coordinator::ComponentManager;
+    using SystemManager    = Coordinator::SystemManager;
+    using ISystem          = ecs::ISystem<Coordinator>;
 
 #undef NEXUS_COMPONENTS
 }
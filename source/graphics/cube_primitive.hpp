@@ -62,6 +62,21 @@ namespace nexus
             gl::glBindVertexArray(0);
         }
 
+        // draw `count` cubes, their per instance attributes must be attached to `vao()`
+        void draw_instanced(std::size_t count) const
+        {
+            gl::glBindVertexArray(m_vao);
+            gl::glDrawArraysInstanced(
+                gl::GL_TRIANGLES,
+                0,
+                static_cast<gl::GLsizei>(num_of_vertices),
+                static_cast<gl::GLsizei>(count)
+            );
+            gl::glBindVertexArray(0);
+        }
+
+        unsigned int vao() const { return m_vao; }
+
         void delete_buffers()
         {
             if (m_vao != 0) {
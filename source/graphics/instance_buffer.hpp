@@ -0,0 +1,129 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glbinding/gl/gl.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <utility>
+
+namespace nexus
+{
+    // per instance attributes, the layout matches `asset/shader/shader.vert`
+    struct InstanceData
+    {
+        glm::mat4 m_model;
+        glm::vec3 m_color;
+    };
+
+    /**
+     * @brief A vertex buffer of per instance attributes, rewritten every frame.
+     *
+     * Each upload orphans the previous storage before writing to it, so the driver can hand out fresh memory
+     * instead of stalling until the draws still reading the old data are done.
+     */
+    class InstanceBuffer
+    {
+    public:
+        static constexpr gl::GLuint model_location = 2;    // a mat4 takes 4 locations, one per column
+        static constexpr gl::GLuint color_location = 6;
+
+        InstanceBuffer() { gl::glGenBuffers(1, &m_vbo); }
+
+        InstanceBuffer(InstanceBuffer&& other)
+            : m_vbo{ std::exchange(other.m_vbo, 0) }
+            , m_capacity{ std::exchange(other.m_capacity, 0) }
+            , m_count{ std::exchange(other.m_count, 0) }
+        {
+        }
+
+        InstanceBuffer& operator=(InstanceBuffer&& other)
+        {
+            if (this == &other) {
+                return *this;
+            }
+
+            delete_buffer();
+
+            m_vbo      = std::exchange(other.m_vbo, 0);
+            m_capacity = std::exchange(other.m_capacity, 0);
+            m_count    = std::exchange(other.m_count, 0);
+
+            return *this;
+        }
+
+        InstanceBuffer(const InstanceBuffer&)            = delete;
+        InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+        // like the primitives, must be destroyed before glfwTerminate() is called
+        ~InstanceBuffer() { delete_buffer(); }
+
+        /**
+         * @brief Point the per instance attributes of a vertex array to this buffer.
+         *
+         * @param vao The vertex array of the mesh to draw instanced.
+         */
+        void attach(gl::GLuint vao) const
+        {
+            auto stride = static_cast<gl::GLsizei>(sizeof(InstanceData));
+
+            gl::glBindVertexArray(vao);
+            gl::glBindBuffer(gl::GL_ARRAY_BUFFER, m_vbo);
+
+            for (auto column = 0u; column < 4; ++column) {
+                auto location = model_location + column;
+                auto offset   = offsetof(InstanceData, m_model) + column * sizeof(glm::vec4);
+
+                gl::glVertexAttribPointer(location, 4, gl::GL_FLOAT, gl::GL_FALSE, stride, (void*)offset);
+                gl::glEnableVertexAttribArray(location);
+                gl::glVertexAttribDivisor(location, 1);
+            }
+
+            auto offset = offsetof(InstanceData, m_color);
+            gl::glVertexAttribPointer(color_location, 3, gl::GL_FLOAT, gl::GL_FALSE, stride, (void*)offset);
+            gl::glEnableVertexAttribArray(color_location);
+            gl::glVertexAttribDivisor(color_location, 1);
+
+            gl::glBindBuffer(gl::GL_ARRAY_BUFFER, 0);
+            gl::glBindVertexArray(0);
+        }
+
+        void upload(std::span<const InstanceData> instances)
+        {
+            auto bytes = instances.size_bytes();
+
+            gl::glBindBuffer(gl::GL_ARRAY_BUFFER, m_vbo);
+
+            // grow geometrically so a slowly growing scene doesn't reallocate every frame
+            if (bytes > m_capacity) {
+                m_capacity = std::max(bytes, m_capacity * 2);
+            }
+
+            // orphan, then fill the new storage
+            auto capacity = static_cast<gl::GLsizeiptr>(m_capacity);
+            gl::glBufferData(gl::GL_ARRAY_BUFFER, capacity, nullptr, gl::GL_STREAM_DRAW);
+            gl::glBufferSubData(gl::GL_ARRAY_BUFFER, 0, static_cast<gl::GLsizeiptr>(bytes), instances.data());
+
+            gl::glBindBuffer(gl::GL_ARRAY_BUFFER, 0);
+
+            m_count = instances.size();
+        }
+
+        // number of instances of the last upload
+        std::size_t count() const { return m_count; }
+
+    private:
+        void delete_buffer()
+        {
+            if (m_vbo != 0) {
+                gl::glDeleteBuffers(1, &m_vbo);
+                m_vbo = 0;
+            }
+        }
+
+        gl::GLuint  m_vbo      = 0;
+        std::size_t m_capacity = 0;    // in bytes
+        std::size_t m_count    = 0;
+    };
+}
@@ -28,6 +28,19 @@ namespace nexus
     template <typename Float>
     concept UniformMatType = ecs::util::OneOf<Float, gl::GLfloat, gl::GLdouble>;
 
+    /**
+     * @brief A uniform of a shader program, its location resolved once.
+     *
+     * Obtained from `Shader::uniform`, setting it with `Shader::set_uniform` skips the name lookup.
+     *
+     * @tparam T The type of the value the uniform is set with.
+     */
+    template <typename T>
+    struct Uniform
+    {
+        gl::GLint m_location = -1;
+    };
+
     class Shader
     {
     public:
@@ -87,6 +100,7 @@ namespace nexus
             }
             gl::glLinkProgram(m_id);
             shader_link_info(m_id);
+            resolve_uniforms();
 
             // delete shader objects
             gl::glDeleteShader(vs_id);
@@ -129,34 +143,46 @@ namespace nexus
         void use() const { gl::glUseProgram(m_id); }
         void unuse() const { gl::glUseProgram(0); }
 
-        // glm vector
-        // clang-format off
-        template <UniformValueType Type> void set_uniform(const std::string& name, const glm::vec<2, Type>& vec) { set_uniform_vec_impl<Type, 2>(name, &vec[0]); }
-        template <UniformValueType Type> void set_uniform(const std::string& name, const glm::vec<3, Type>& vec) { set_uniform_vec_impl<Type, 3>(name, &vec[0]); }
-        template <UniformValueType Type> void set_uniform(const std::string& name, const glm::vec<4, Type>& vec) { set_uniform_vec_impl<Type, 4>(name, &vec[0]); }
-
-        // glm::matrix
-        template <UniformMatType Type> void set_uniform(const std::string& name, const glm::mat<2, 2, Type>& mat2) { set_uniform_mat_impl<Type, 2>(name, mat2); }
-        template <UniformMatType Type> void set_uniform(const std::string& name, const glm::mat<3, 3, Type>& mat3) { set_uniform_mat_impl<Type, 3>(name, mat3); }
-        template <UniformMatType Type> void set_uniform(const std::string& name, const glm::mat<4, 4, Type>& mat4) { set_uniform_mat_impl<Type, 4>(name, mat4); }
+        /**
+         * @brief Get a handle to a uniform, to set it without looking its name up every time.
+         *
+         * The locations of every active uniform are resolved when the program is linked, so this never calls
+         * into the driver.
+         */
+        template <typename T>
+        Uniform<T> uniform(const std::string& name)
+        {
+            return { get_loc(name) };
+        }
 
-        // simple array; 2 to 4 elements
-        template <UniformValueType Type, std::size_t N> requires(N >= 2 && N <= 4) void set_uniform(const std::string& name, const std::array<Type, N>& value) { set_uniform_vec_impl<Type, N>(name, &value[0]); }
-        // clang-format on
+        /**
+         * @brief Bind a uniform block of this program to a binding point.
+         *
+         * Every program with the block bound to the same point reads the uniform buffer bound there, so data
+         * shared across programs is only uploaded once.
+         */
+        void bind_uniform_block(const std::string& name, gl::GLuint binding)
+        {
+            auto index = gl::glGetUniformBlockIndex(m_id, name.c_str());
+            if (index == gl::GL_INVALID_INDEX) {
+                std::cerr << std::format(
+                    "WARNING: [Shader] [{}]: Uniform block of name '{}' can't be found\n", m_id, name
+                );
+                return;
+            }
+            gl::glUniformBlockBinding(m_id, index, binding);
+        }
 
-        // one value
-        template <UniformValueType Type>
-        void set_uniform(const std::string& name, Type value)
+        template <typename T>
+        void set_uniform(Uniform<T> uniform, const T& value)
         {
-            auto loc = get_loc(name);
+            set_uniform_at(uniform.m_location, value);
+        }
 
-            // clang-format off
-            if      constexpr (std::same_as<Type, gl::GLfloat>)  gl::glUniform1f(loc, value);
-            else if constexpr (std::same_as<Type, gl::GLdouble>) gl::glUniform1d(loc, value);
-            else if constexpr (std::same_as<Type, gl::GLint>)    gl::glUniform1i(loc, value);
-            else if constexpr (std::same_as<Type, bool>)         gl::glUniform1i(loc, value);
-            else if constexpr (std::same_as<Type, gl::GLuint>)   gl::glUniform1ui(loc, value);
-            // clang-format on
+        template <typename T>
+        void set_uniform(const std::string& name, const T& value)
+        {
+            set_uniform_at(get_loc(name), value);
         }
 
         // two values (use array)
@@ -164,7 +190,7 @@ namespace nexus
         void set_uniform(const std::string& name, Type v0, Type v1)
         {
             std::array value{ v0, v1 };
-            set_uniform<Type, 2>(name, value);
+            set_uniform(name, value);
         }
 
         // three values (use array)
@@ -172,7 +198,7 @@ namespace nexus
         void set_uniform(const std::string& name, Type v0, Type v1, Type v2)
         {
             std::array value{ v0, v1, v2 };
-            set_uniform<Type, 3>(name, value);
+            set_uniform(name, value);
         }
 
         // four values (use array)
@@ -180,7 +206,7 @@ namespace nexus
         void set_uniform(const std::string& name, Type v0, Type v1, Type v2, Type v3)
         {
             std::array value{ v0, v1, v2, v3 };
-            set_uniform<Type, 4>(name, value);
+            set_uniform(name, value);
         }
 
     private:
@@ -191,6 +217,62 @@ namespace nexus
             GEOMETRY,
         };
 
+        // glm vector
+        // clang-format off
+        template <UniformValueType Type> void set_uniform_at(gl::GLint loc, const glm::vec<2, Type>& vec) { set_uniform_vec_impl<Type, 2>(loc, &vec[0]); }
+        template <UniformValueType Type> void set_uniform_at(gl::GLint loc, const glm::vec<3, Type>& vec) { set_uniform_vec_impl<Type, 3>(loc, &vec[0]); }
+        template <UniformValueType Type> void set_uniform_at(gl::GLint loc, const glm::vec<4, Type>& vec) { set_uniform_vec_impl<Type, 4>(loc, &vec[0]); }
+
+        // glm::matrix
+        template <UniformMatType Type> void set_uniform_at(gl::GLint loc, const glm::mat<2, 2, Type>& mat2) { set_uniform_mat_impl<Type, 2>(loc, mat2); }
+        template <UniformMatType Type> void set_uniform_at(gl::GLint loc, const glm::mat<3, 3, Type>& mat3) { set_uniform_mat_impl<Type, 3>(loc, mat3); }
+        template <UniformMatType Type> void set_uniform_at(gl::GLint loc, const glm::mat<4, 4, Type>& mat4) { set_uniform_mat_impl<Type, 4>(loc, mat4); }
+
+        // simple array; 2 to 4 elements
+        template <UniformValueType Type, std::size_t N> requires(N >= 2 && N <= 4) void set_uniform_at(gl::GLint loc, const std::array<Type, N>& value) { set_uniform_vec_impl<Type, N>(loc, &value[0]); }
+        // clang-format on
+
+        // one value
+        template <UniformValueType Type>
+        void set_uniform_at(gl::GLint loc, Type value)
+        {
+            // clang-format off
+            if      constexpr (std::same_as<Type, gl::GLfloat>)  gl::glUniform1f(loc, value);
+            else if constexpr (std::same_as<Type, gl::GLdouble>) gl::glUniform1d(loc, value);
+            else if constexpr (std::same_as<Type, gl::GLint>)    gl::glUniform1i(loc, value);
+            else if constexpr (std::same_as<Type, bool>)         gl::glUniform1i(loc, value);
+            else if constexpr (std::same_as<Type, gl::GLuint>)   gl::glUniform1ui(loc, value);
+            // clang-format on
+        }
+
+        // cache the locations of every active uniform, arrays are registered by their base name too
+        void resolve_uniforms()
+        {
+            gl::GLint count{};
+            gl::GLint max_length{};
+            gl::glGetProgramiv(m_id, gl::GL_ACTIVE_UNIFORMS, &count);
+            gl::glGetProgramiv(m_id, gl::GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+
+            auto name = std::string((std::size_t)max_length, '\0');
+            for (auto i = 0; i < count; ++i) {
+                gl::GLsizei length{};
+                gl::GLint   size{};
+                gl::GLenum  type{};
+                gl::glGetActiveUniform(m_id, (gl::GLuint)i, max_length, &length, &size, &type, name.data());
+
+                auto active = name.substr(0, (std::size_t)length);
+                auto loc    = gl::glGetUniformLocation(m_id, active.c_str());
+                if (loc == -1) {
+                    continue;    // member of a uniform block
+                }
+
+                m_uniform_loc_history.emplace(active, loc);
+                if (active.ends_with("[0]")) {
+                    m_uniform_loc_history.emplace(active.substr(0, active.size() - 3), loc);
+                }
+            }
+        }
+
         gl::GLint get_loc(const std::string& name)
         {
             if (auto found = m_uniform_loc_history.find(name); found != m_uniform_loc_history.end()) {
@@ -268,10 +350,8 @@ namespace nexus
         // vector
         template <UniformValueType Type, std::size_t N>
             requires (N >= 2 && N <= 4)
-        void set_uniform_vec_impl(const std::string& name, const Type* value)
+        void set_uniform_vec_impl(gl::GLint loc, const Type* value)
         {
-            gl::GLint loc{ get_loc(name) };
-
             // another C limitation, the const does not matter
             auto val{ const_cast<Type*>(value) };
 
@@ -301,9 +381,8 @@ namespace nexus
         // matrix
         template <UniformMatType Type, std::size_t N>
             requires (N >= 2 && N <= 4)
-        void set_uniform_mat_impl(const std::string& name, const glm::mat<N, N, Type>& mat)
+        void set_uniform_mat_impl(gl::GLint loc, const glm::mat<N, N, Type>& mat)
         {
-            gl::GLint loc{ get_loc(name) };
             // clang-format off
             if      constexpr (std::same_as<Type, gl::GLfloat> && N == 2) gl::glUniformMatrix2fv(loc, 1, gl::GL_FALSE, &mat[0][0]);
             else if constexpr (std::same_as<Type, gl::GLfloat> && N == 3) gl::glUniformMatrix3fv(loc, 1, gl::GL_FALSE, &mat[0][0]);
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <glbinding/gl/gl.h>
+
+#include <type_traits>
+#include <utility>
+
+namespace nexus
+{
+    /**
+     * @brief A uniform buffer holding one `Block`, bound to a fixed binding point.
+     *
+     * `Block` must mirror a `layout(std140)` uniform block: members aligned to 16 bytes except for scalars
+     * and vec2, matrices stored as vec4 columns. Shaders read it once they bind the block to the same point
+     * with `Shader::bind_uniform_block`.
+     */
+    template <typename Block>
+        requires std::is_trivially_copyable_v<Block>
+    class UniformBuffer
+    {
+    public:
+        explicit UniformBuffer(gl::GLuint binding)
+            : m_binding{ binding }
+        {
+            gl::glGenBuffers(1, &m_ubo);
+            gl::glBindBuffer(gl::GL_UNIFORM_BUFFER, m_ubo);
+            gl::glBufferData(gl::GL_UNIFORM_BUFFER, sizeof(Block), nullptr, gl::GL_DYNAMIC_DRAW);
+            gl::glBindBuffer(gl::GL_UNIFORM_BUFFER, 0);
+
+            gl::glBindBufferBase(gl::GL_UNIFORM_BUFFER, m_binding, m_ubo);
+        }
+
+        UniformBuffer(UniformBuffer&& other)
+            : m_ubo{ std::exchange(other.m_ubo, 0) }
+            , m_binding{ other.m_binding }
+        {
+        }
+
+        UniformBuffer& operator=(UniformBuffer&& other)
+        {
+            if (this == &other) {
+                return *this;
+            }
+
+            delete_buffer();
+
+            m_ubo     = std::exchange(other.m_ubo, 0);
+            m_binding = other.m_binding;
+
+            return *this;
+        }
+
+        UniformBuffer(const UniformBuffer&)            = delete;
+        UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+        ~UniformBuffer() { delete_buffer(); }
+
+        void update(const Block& block)
+        {
+            gl::glBindBuffer(gl::GL_UNIFORM_BUFFER, m_ubo);
+            gl::glBufferSubData(gl::GL_UNIFORM_BUFFER, 0, sizeof(Block), &block);
+            gl::glBindBuffer(gl::GL_UNIFORM_BUFFER, 0);
+        }
+
+        gl::GLuint binding() const { return m_binding; }
+
+    private:
+        void delete_buffer()
+        {
+            if (m_ubo != 0) {
+                gl::glDeleteBuffers(1, &m_ubo);
+                m_ubo = 0;
+            }
+        }
+
+        gl::GLuint m_ubo = 0;
+        gl::GLuint m_binding;
+    };
+}
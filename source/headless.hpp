@@ -0,0 +1,233 @@
+#pragma once
+
+#include "system/collision_system.hpp"
+#include "system/physics_system.hpp"
+#include "system/spatial_index_system.hpp"
+#include "ecs_config.hpp"
+#include "replication_mirror.hpp"
+#include "scene.hpp"
+
+#include <ecs/common.hpp>
+#include <ecs/coordinator.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <print>
+#include <string_view>
+#include <vector>
+
+namespace nexus
+{
+    /**
+     * @brief The simulation of nexus without a window, for profiling where there is no display or GL.
+     *
+     * Runs the systems of nexus that don't render over the same scene, stepped with a fixed time step, and
+     * records how long each frame and each system took.
+     */
+    class Headless
+    {
+    public:
+        struct Options
+        {
+            std::size_t   m_cube_count = scene_cube_count;
+            std::size_t   m_frames     = 1000;
+            std::size_t   m_warmup     = 10;    // frames run before recording, not counted in `m_frames`
+            ecs::Duration m_dt         = ecs::Duration{ 1.0f / 60.0f };
+            std::uint32_t m_seed       = 42;
+        };
+
+        explicit Headless(const Options& options)
+            : m_options{ options }
+            , m_coordinator{ options.m_cube_count }
+        {
+            // the same systems as nexus, in the same order
+            m_physics_system    = &m_coordinator.create_system<nexus::PhysicsSystem>();
+            auto& spatial_index = m_coordinator.create_system<nexus::SpatialIndexSystem>(m_coordinator);
+            auto& collision     = m_coordinator.create_system<nexus::CollisionSystem>();
+
+            m_timings = {
+                Timing{ "physics", m_physics_system },
+                Timing{ "spatial_index", &spatial_index },
+                Timing{ "collision", &collision },
+            };
+
+            spawn_scene(m_coordinator, options.m_cube_count, options.m_seed);
+        }
+
+        /**
+         * @brief Mirror the recorded frames into a second coordinator over a socket pair, see
+         * `ReplicationMirror`.
+         *
+         * @return False if the socket pair can't be created.
+         */
+        bool start_replication()
+        {
+            m_replication = std::make_unique<ReplicationMirror>();
+            if (not m_replication->start()) {
+                m_replication.reset();
+                return false;
+            }
+            return true;
+        }
+
+        void run()
+        {
+            for (auto i = 0uz; i < m_options.m_warmup; ++i) {
+                m_coordinator.update(m_options.m_dt);
+            }
+
+            m_frame_times.reserve(m_options.m_frames);
+            for (auto& timing : m_timings) {
+                timing.m_times.reserve(m_options.m_frames);
+            }
+
+            for (auto i = 0uz; i < m_options.m_frames; ++i) {
+                auto start = ecs::Clock::now();
+                m_coordinator.update(m_options.m_dt);
+                m_frame_times.push_back(ecs::Clock::now() - start);
+
+                for (auto& timing : m_timings) {
+                    timing.m_times.push_back(timing.m_system->last_update_time());
+                }
+
+                if (m_replication) {
+                    m_replication->send(m_coordinator);
+                }
+            }
+
+            if (m_replication) {
+                m_replication->stop();
+                m_mismatches = m_replication->mismatches(m_coordinator);
+            }
+        }
+
+        // whether the mirror received every frame and ended up with the same components, if replicating
+        bool replicated() const
+        {
+            return not m_replication
+                or (m_replication->status() == ecs::ReplicationStatus::Closed and m_mismatches == 0);
+        }
+
+        /**
+         * @brief Write the 50th, 95th, and 99th percentile of the frame and system times as JSON.
+         */
+        void write_stats(std::FILE* file) const
+        {
+            auto write = [&](std::string_view name, std::vector<ecs::Duration> times, std::string_view end) {
+                std::println(
+                    file,
+                    R"(    "{}": {{ "p50_ms": {:.4f}, "p95_ms": {:.4f}, "p99_ms": {:.4f} }}{})",
+                    name,
+                    milliseconds(percentile(times, 0.50f)),
+                    milliseconds(percentile(times, 0.95f)),
+                    milliseconds(percentile(times, 0.99f)),
+                    end
+                );
+            };
+
+            std::println(file, "{{");
+            std::println(file, R"(  "cubes": {},)", m_options.m_cube_count);
+            std::println(file, R"(  "frames": {},)", m_options.m_frames);
+            std::println(file, R"(  "dt": {},)", m_options.m_dt.count());
+            std::println(file, R"(  "seed": {},)", m_options.m_seed);
+            std::println(file, R"(  "storage": "{}",)", ecs_config::storage_name);
+            std::println(file, R"(  "physics_kernel": "{}",)", physics::name(m_physics_system->isa()));
+
+            if (m_replication) {
+                write_replication(file);
+            }
+
+            std::println(file, R"(  "times": {{)");
+
+            write("frame", m_frame_times, ",");
+            for (auto i = 0uz; i < m_timings.size(); ++i) {
+                write(m_timings[i].m_name, m_timings[i].m_times, i + 1 < m_timings.size() ? "," : "");
+            }
+
+            std::println(file, "  }}");
+            std::println(file, "}}");
+        }
+
+        // the runs of the systems over the last frames, see `ecs::Profiler`
+        void write_trace(std::FILE* file) const { m_coordinator.profiler().write_chrome_trace(file); }
+
+    private:
+        struct Timing
+        {
+            std::string_view           m_name   = {};
+            const ecs_config::ISystem* m_system = nullptr;
+            std::vector<ecs::Duration> m_times  = {};
+        };
+
+        // the size of the first frame, which holds the whole scene, then the sizes of the following ones and
+        // the time taken to send each, and whether the mirror ended up with every cube and its components
+        void write_replication(std::FILE* file) const
+        {
+            auto sizes = m_replication->frame_sizes();
+            auto times = m_replication->send_times();
+            auto first = sizes.empty() ? 0uz : sizes.front();
+            if (not sizes.empty()) {
+                sizes.erase(sizes.begin());
+            }
+
+            auto entities = 0uz;
+            m_replication->mirror().for_each_entity([&](ecs::Entity, ecs::Signature) { ++entities; });
+
+            std::println(file, R"(  "replication": {{)");
+            std::println(file, R"(    "status": "{}",)", ecs::to_string(m_replication->status()));
+            std::println(file, R"(    "mirrored_entities": {},)", entities);
+            std::println(file, R"(    "mismatched_entities": {},)", m_mismatches);
+            std::println(file, R"(    "first_frame_bytes": {},)", first);
+            std::println(
+                file,
+                R"(    "frame_bytes": {{ "p50": {}, "p95": {}, "p99": {} }},)",
+                percentile(sizes, 0.50f),
+                percentile(sizes, 0.95f),
+                percentile(sizes, 0.99f)
+            );
+            std::println(
+                file,
+                R"(    "send": {{ "p50_ms": {:.4f}, "p95_ms": {:.4f}, "p99_ms": {:.4f} }})",
+                milliseconds(percentile(times, 0.50f)),
+                milliseconds(percentile(times, 0.95f)),
+                milliseconds(percentile(times, 0.99f))
+            );
+            std::println(file, "  }},");
+        }
+
+        // nearest-rank percentile
+        template <typename T>
+        static T percentile(std::vector<T>& values, float fraction)
+        {
+            if (values.empty()) {
+                return T{};
+            }
+
+            auto rank = static_cast<std::size_t>(std::ceil(fraction * static_cast<float>(values.size())));
+            auto nth  = values.begin() + static_cast<std::ptrdiff_t>(std::max(rank, 1uz) - 1);
+            std::ranges::nth_element(values, nth);
+
+            return *nth;
+        }
+
+        static float milliseconds(ecs::Duration duration)
+        {
+            return std::chrono::duration<float, std::milli>{ duration }.count();
+        }
+
+        Options                    m_options;
+        ecs_config::Coordinator    m_coordinator;
+        nexus::PhysicsSystem*      m_physics_system;
+        std::array<Timing, 3>      m_timings;
+        std::vector<ecs::Duration> m_frame_times;
+
+        std::unique_ptr<ReplicationMirror> m_replication;    // null unless requested
+        std::size_t                        m_mismatches = 0;
+    };
+}
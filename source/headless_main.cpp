@@ -0,0 +1,123 @@
+#include "headless.hpp"
+
+#include <charconv>
+#include <cstdio>
+#include <optional>
+#include <print>
+#include <string_view>
+
+namespace
+{
+    template <typename T>
+    std::optional<T> parse(std::string_view str)
+    {
+        auto value        = T{};
+        auto [end, error] = std::from_chars(str.data(), str.data() + str.size(), value);
+
+        if (error != std::errc{} or end != str.data() + str.size()) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    void usage(std::string_view program)
+    {
+        std::println(
+            stderr,
+            "usage: {} [--cubes <n>] [--frames <n>] [--warmup <n>] [--dt <seconds>] [--seed <n>] "
+            "[--output <file>] [--trace <file>] [--replicate]",
+            program
+        );
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto options   = nexus::Headless::Options{};
+    auto output    = std::string_view{ "nexus-headless.json" };
+    auto trace     = std::string_view{};
+    auto replicate = false;
+
+    for (auto i = 1; i < argc; ++i) {
+        auto arg = std::string_view{ argv[i] };
+
+        // the only option without a value
+        if (arg == "--replicate") {
+            replicate = true;
+            continue;
+        }
+
+        auto value = i + 1 < argc ? std::string_view{ argv[++i] } : std::string_view{};
+
+        // keeps the default if the value is invalid
+        auto set = [&]<typename T>(T& field) {
+            auto parsed = parse<T>(value);
+            field       = parsed.value_or(field);
+            return parsed.has_value();
+        };
+
+        auto valid = false;
+        if (arg == "--cubes") {
+            valid = set(options.m_cube_count);
+        } else if (arg == "--frames") {
+            valid = set(options.m_frames);
+        } else if (arg == "--warmup") {
+            valid = set(options.m_warmup);
+        } else if (arg == "--seed") {
+            valid = set(options.m_seed);
+        } else if (arg == "--dt") {
+            auto dt      = parse<float>(value);
+            valid        = dt > 0.0f;
+            options.m_dt = ecs::Duration{ dt.value_or(0.0f) };
+        } else if (arg == "--output") {
+            valid  = not value.empty();
+            output = value;
+        } else if (arg == "--trace") {
+            valid = not value.empty();
+            trace = value;
+        }
+
+        if (not valid) {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (not trace.empty() and not ecs::config::profile) {
+        std::println(stderr, "--trace needs a build with SIMPLE_ECS_PROFILE defined");
+        return 1;
+    }
+
+    auto headless = nexus::Headless{ options };
+    if (replicate and not headless.start_replication()) {
+        std::println(stderr, "failed to create the socket pair for --replicate");
+        return 1;
+    }
+    headless.run();
+
+    // the output is a null terminated argument or the default
+    auto* file = std::fopen(output.data(), "w");
+    if (file == nullptr) {
+        std::println(stderr, "failed to open '{}' for writing", output);
+        return 1;
+    }
+    headless.write_stats(file);
+    std::fclose(file);
+
+    if (not trace.empty()) {
+        auto* trace_file = std::fopen(trace.data(), "w");
+        if (trace_file == nullptr) {
+            std::println(stderr, "failed to open '{}' for writing", trace);
+            return 1;
+        }
+        headless.write_trace(trace_file);
+        std::fclose(trace_file);
+    }
+
+    headless.write_stats(stdout);
+
+    if (not headless.replicated()) {
+        std::println(stderr, "the mirror doesn't match the simulation, see \"replication\" above");
+        return 1;
+    }
+}
@@ -1,7 +1,32 @@
 #include "nexus.hpp"
 
-int main()
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <print>
+#include <string_view>
+#include <system_error>
+
+int main(int argc, char** argv)
 {
+    // `--frames <n>` runs that many frames and checks that they were drawn, see `Nexus::run_frames`
+    auto frames = 0uz;
+    if (argc > 1) {
+        auto arg   = std::string_view{ argv[1] };
+        auto value = argc == 3 ? std::string_view{ argv[2] } : std::string_view{};
+
+        auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), frames);
+        if (arg != "--frames" or error != std::errc{} or end != value.data() + value.size() or frames == 0) {
+            std::println(stderr, "usage: {} [--frames <n>]", argv[0]);
+            return 1;
+        }
+    }
+
     auto nexus = nexus::Nexus{ "simple-ecs (nexus)", 1280, 720 };
-    nexus.run();
+    if (frames == 0) {
+        nexus.run();
+        return 0;
+    }
+
+    return nexus.run_frames(frames) ? 0 : 1;
 }
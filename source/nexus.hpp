@@ -6,18 +6,25 @@
 #include "component/transform.hpp"
 #include "graphics/shader.hpp"
 #include "system/camera_control_system.hpp"
+#include "system/collision_system.hpp"
 #include "system/physics_system.hpp"
 #include "system/render_system.hpp"
+#include "system/spatial_index_system.hpp"
+#include "telemetry/frame_telemetry.hpp"
 #include "ecs_config.hpp"
+#include "scene.hpp"
 
 #include <ecs/common.hpp>
 #include <ecs/entity_manager.hpp>
 #include <ecs/coordinator.hpp>
 
 #include <glfw_cpp/glfw_cpp.hpp>
+#include <glbinding/gl/gl.h>
 #include <glbinding/glbinding.h>
 
-#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <print>
 #include <random>
 #include <string_view>
@@ -61,17 +68,23 @@ namespace nexus
     class Nexus
     {
     public:
+        // number of entities in the scene, including the camera
+        static constexpr std::size_t entity_count = scene_cube_count + 1;
+
         Nexus(std::string_view title, int width, int height)
             : m_glfw{ init_glfw() }
             , m_wm{ m_glfw->createWindowManager() }
             , m_window{ m_wm->createWindow({}, title, width, height) }
-            , m_coordinator{}
+            , m_coordinator{ entity_count }
         {
             m_window.setVsync(true);
 
+            // these read the transforms physics writes, so they run after it
             m_coordinator.create_system<nexus::PhysicsSystem>();
+            m_coordinator.create_system<nexus::SpatialIndexSystem>(m_coordinator);
+            m_collision_system = &m_coordinator.create_system<nexus::CollisionSystem>();
             m_coordinator.create_system<nexus::CameraControlSystem>(m_window);
-            m_coordinator.create_system<nexus::RenderSystem>(
+            m_render_system = &m_coordinator.create_system<nexus::RenderSystem>(
                 m_coordinator,
                 m_window,
                 nexus::Shader{
@@ -83,54 +96,7 @@ namespace nexus
 
         void run()
         {
-            using AllComponents = ecs::util::TupleCatUniq<
-                nexus::PhysicsSystem::Components,    //
-                nexus::RenderSystem::Components>;
-
-            auto rand_pos   = RandomGenerator{ -125.0f, 125.0f };
-            auto rand_rot   = RandomGenerator{ 0.0f, 3.14f };
-            auto rand_vel   = RandomGenerator{ -100.0f, 100.0f };
-            auto rand_scale = RandomGenerator{ 1.0f, 4.0f };
-            auto rand_color = RandomGenerator{ 0.0f, 1.0f };
-
-            auto grav = [&rand_scale](float scale) {
-                auto range = rand_scale.range();
-                return glm::vec3{ 0.0f, -9.8f * scale / range, 0.0f };
-            };
-
-            for (auto i = 0uz; i < ecs::config::max_entities - 1; ++i) {
-                auto entity = m_coordinator.create_entity();
-
-                auto scale    = rand_scale();
-                auto vel      = [&] { return rand_vel() / scale; };
-                auto avel     = [&] { return rand_rot() / scale; };
-                auto vel_half = [&] {
-                    auto range = rand_scale.range();
-                    return (rand_vel() + range / 2.0f) / scale;
-                };
-
-                m_coordinator.add_component_tuple<AllComponents>(
-                    entity,
-                    {
-                        nexus::Gravity{
-                            .m_force = grav(scale),
-                        },
-                        nexus::RigidBody{
-                            .m_velocity         = glm::vec3{ vel(), vel_half(), vel() },
-                            .m_acceleration     = glm::vec3{ 0.0f, 0.0f, 0.0f },
-                            .m_angular_velocity = glm::vec3{ avel(), avel(), avel() },
-                        },
-                        nexus::Transform{
-                            .m_position = glm::vec3{ rand_pos(), rand_pos(), rand_pos() },
-                            .m_scale    = glm::vec3{ scale },
-                            .m_rotation = glm::vec3{ rand_rot(), rand_rot(), rand_rot() },
-                        },
-                        nexus::Renderable{
-                            .m_color = glm::vec3{ rand_color(), rand_color(), rand_color() },
-                        },
-                    }
-                );
-            }
+            spawn_scene(m_coordinator, scene_cube_count, std::random_device{}());
 
             // reset timer
             m_timer.elapsed();
@@ -140,35 +106,59 @@ namespace nexus
                 m_coordinator.update(elapsed);
                 m_wm->pollEvents();
 
-                std::println("Frame time: {}", elapsed);
+                const auto& [visited, visible, culled, reinserted] = m_render_system->culling_stats();
+                m_telemetry.record({
+                    .m_frame_time    = elapsed,
+                    .m_visible       = static_cast<std::uint32_t>(visible),
+                    .m_culled        = static_cast<std::uint32_t>(culled),
+                    .m_nodes_visited = static_cast<std::uint32_t>(visited),
+                    .m_reinserted    = static_cast<std::uint32_t>(reinserted),
+                    .m_pairs         = static_cast<std::uint32_t>(m_collision_system->pairs().size()),
+                });
             }
         }
 
-    private:
-        template <std::floating_point T>
-        struct RandomGenerator
+        /**
+         * @brief Run a number of frames of a fixed time step over a fixed scene, then check the rendering.
+         *
+         * Meant for checking the drawing where there is no GPU or display, e.g. with Mesa's software
+         * renderer on a virtual display.
+         *
+         * @return False if OpenGL reported an error or the last frame drew nothing.
+         */
+        bool run_frames(std::size_t count, ecs::Duration dt = ecs::Duration{ 1.0f / 60.0f })
         {
-        public:
-            RandomGenerator(T min, T max)
-                : m_dist{ min, max }
-            {
+            spawn_scene(m_coordinator, scene_cube_count, 42);
+
+            auto errors = 0uz;
+            for (auto i = 0uz; i < count and m_wm->hasWindowOpened(); ++i) {
+                m_coordinator.update(dt);
+                m_wm->pollEvents();
+
+                m_window.bind();
+                for (auto error = gl::glGetError(); error != gl::GL_NO_ERROR; error = gl::glGetError()) {
+                    std::println(stderr, "frame {}: OpenGL error {:#x}", i, static_cast<unsigned>(error));
+                    ++errors;
+                }
+                m_window.unbind();
             }
 
-            T operator()() { return m_dist(m_rng); }
-            T min() { return m_dist.min(); }
-            T max() { return m_dist.max(); }
-            T range() { return max() - min(); }
+            auto visible = m_render_system->culling_stats().m_visible;
+            std::println("{} cubes drawn in the last frame, {} OpenGL errors", visible, errors);
 
-        private:
-            std::mt19937                      m_rng = std::mt19937{ std::random_device{}() };
-            std::uniform_real_distribution<T> m_dist;
-        };
+            return errors == 0 and visible > 0;
+        }
 
+    private:
         glfw_cpp::Instance::Unique      m_glfw;
         glfw_cpp::WindowManager::Shared m_wm;
         glfw_cpp::Window                m_window;
 
         ecs::Timer              m_timer;
         ecs_config::Coordinator m_coordinator;
+        nexus::RenderSystem*    m_render_system;
+        nexus::CollisionSystem* m_collision_system;
+
+        telemetry::FrameTelemetry m_telemetry{ stdout };
     };
 }
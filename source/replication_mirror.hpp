@@ -0,0 +1,109 @@
+#pragma once
+
+#include "ecs_config.hpp"
+
+#include <ecs/common.hpp>
+#include <ecs/replication.hpp>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace nexus
+{
+    /**
+     * @brief Mirrors a coordinator into another one over a local socket pair, as an observer process would.
+     *
+     * `send` writes the changes since the previous frame to one end of the socket pair, and a background
+     * thread reads them from the other end and applies them to the mirror. The size of each frame and the
+     * time spent encoding and writing it are recorded.
+     */
+    class ReplicationMirror
+    {
+    public:
+        ReplicationMirror() = default;
+
+        ~ReplicationMirror() { stop(); }
+
+        ReplicationMirror(ReplicationMirror&&)            = delete;
+        ReplicationMirror& operator=(ReplicationMirror&&) = delete;
+
+        // false if the socket pair can't be created
+        bool start()
+        {
+            if (::socketpair(AF_UNIX, SOCK_STREAM, 0, m_fds.data()) != 0) {
+                return false;
+            }
+
+            m_thread = std::jthread{ [this] {
+                auto source = ecs::replication::FdSource{ m_fds[1] };
+                do {
+                    m_status = m_reader.read(source, m_mirror);
+                } while (m_status == ecs::ReplicationStatus::Ok);
+
+                // makes `send` fail instead of blocking once the socket is full
+                ::shutdown(m_fds[1], SHUT_RD);
+            } };
+
+            return true;
+        }
+
+        void send(const ecs_config::Coordinator& coordinator)
+        {
+            auto sink = [&](std::span<const std::byte> frame) {
+                m_frame_sizes.push_back(frame.size());
+                return ecs::replication::FdSink{ m_fds[0] }(frame);
+            };
+
+            auto start = ecs::Clock::now();
+            m_writer.write(coordinator, sink);
+            m_send_times.push_back(ecs::Clock::now() - start);
+        }
+
+        // close the stream and wait for the mirror to apply every frame sent
+        void stop()
+        {
+            if (not m_thread.joinable()) {
+                return;
+            }
+
+            ::shutdown(m_fds[0], SHUT_WR);
+            m_thread.join();
+
+            ::close(m_fds[0]);
+            ::close(m_fds[1]);
+        }
+
+        // only once stopped
+        const ecs_config::Coordinator& mirror() const { return m_mirror; }
+
+        // the entities of the source the mirror doesn't have as sent, only once stopped after the last frame
+        std::size_t mismatches(const ecs_config::Coordinator& source) const
+        {
+            return m_reader.mismatches(source, m_mirror);
+        }
+
+        // `Closed` once stopped if every frame was applied
+        ecs::ReplicationStatus status() const { return m_status; }
+
+        const std::vector<std::size_t>&   frame_sizes() const { return m_frame_sizes; }
+        const std::vector<ecs::Duration>& send_times() const { return m_send_times; }
+
+    private:
+        ecs::ReplicationWriter<ecs_config::Coordinator> m_writer;
+        ecs::ReplicationReader<ecs_config::Coordinator> m_reader;
+        ecs_config::Coordinator                         m_mirror;
+        ecs::ReplicationStatus                          m_status = ecs::ReplicationStatus::Ok;
+
+        std::vector<std::size_t>   m_frame_sizes;
+        std::vector<ecs::Duration> m_send_times;
+
+        std::array<int, 2> m_fds = { -1, -1 };
+        std::jthread       m_thread;
+    };
+}
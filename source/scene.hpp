@@ -0,0 +1,105 @@
+#pragma once
+
+#include "component/gravity.hpp"
+#include "component/renderable.hpp"
+#include "component/rigid_body.hpp"
+#include "component/transform.hpp"
+#include "ecs_config.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace nexus
+{
+    // number of cubes in the demo scene
+    constexpr std::size_t scene_cube_count = 4999;
+
+    template <std::floating_point T>
+    class RandomGenerator
+    {
+    public:
+        RandomGenerator(std::mt19937& rng, T min, T max)
+            : m_rng{ &rng }
+            , m_dist{ min, max }
+        {
+        }
+
+        T operator()() { return m_dist(*m_rng); }
+        T min() { return m_dist.min(); }
+        T max() { return m_dist.max(); }
+        T range() { return max() - min(); }
+
+    private:
+        std::mt19937*                     m_rng;
+        std::uniform_real_distribution<T> m_dist;
+    };
+
+    /**
+     * @brief Spawn the cubes of the demo scene, falling and spinning around in a box.
+     *
+     * @param count Number of cubes.
+     * @param seed Seed of the randomness of the scene, the same seed always gives the same scene.
+     */
+    inline void spawn_scene(ecs_config::Coordinator& coordinator, std::size_t count, std::uint32_t seed)
+    {
+        auto rng = std::mt19937{ seed };
+
+        auto rand_pos   = RandomGenerator{ rng, -125.0f, 125.0f };
+        auto rand_rot   = RandomGenerator{ rng, 0.0f, 3.14f };
+        auto rand_vel   = RandomGenerator{ rng, -100.0f, 100.0f };
+        auto rand_scale = RandomGenerator{ rng, 1.0f, 4.0f };
+        auto rand_color = RandomGenerator{ rng, 0.0f, 1.0f };
+
+        auto grav = [&rand_scale](float scale) {
+            auto range = rand_scale.range();
+            return glm::vec3{ 0.0f, -9.8f * scale / range, 0.0f };
+        };
+
+        auto gravities   = std::vector<nexus::Gravity>{};
+        auto rigidbodies = std::vector<nexus::RigidBody>{};
+        auto transforms  = std::vector<nexus::Transform>{};
+        auto renderables = std::vector<nexus::Renderable>{};
+
+        gravities.reserve(count);
+        rigidbodies.reserve(count);
+        transforms.reserve(count);
+        renderables.reserve(count);
+
+        for (auto i = 0uz; i < count; ++i) {
+            auto scale    = rand_scale();
+            auto vel      = [&] { return rand_vel() / scale; };
+            auto avel     = [&] { return rand_rot() / scale; };
+            auto vel_half = [&] {
+                auto range = rand_scale.range();
+                return (rand_vel() + range / 2.0f) / scale;
+            };
+
+            gravities.push_back({
+                .m_force = grav(scale),
+            });
+            rigidbodies.push_back({
+                .m_velocity         = glm::vec3{ vel(), vel_half(), vel() },
+                .m_acceleration     = glm::vec3{ 0.0f, 0.0f, 0.0f },
+                .m_angular_velocity = glm::vec3{ avel(), avel(), avel() },
+            });
+            transforms.push_back({
+                .m_position = glm::vec3{ rand_pos(), rand_pos(), rand_pos() },
+                .m_scale    = glm::vec3{ scale },
+                .m_rotation = glm::vec3{ rand_rot(), rand_rot(), rand_rot() },
+            });
+            renderables.push_back({
+                .m_color = glm::vec3{ rand_color(), rand_color(), rand_color() },
+            });
+        }
+
+        auto entities = coordinator.create_entities(count);
+        coordinator.add_components<nexus::Gravity, nexus::RigidBody, nexus::Transform, nexus::Renderable>(
+            entities, gravities, rigidbodies, transforms, renderables
+        );
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+
+namespace nexus::spatial
+{
+    // axis-aligned bounding box
+    struct Aabb
+    {
+        glm::vec3 m_min;
+        glm::vec3 m_max;
+
+        glm::vec3 center() const { return (m_min + m_max) * 0.5f; }
+        glm::vec3 extent() const { return (m_max - m_min) * 0.5f; }
+
+        // the shapes queried from a `HashGrid` give their bounds
+        const Aabb& bounds() const { return *this; }
+
+        bool contains(glm::vec3 point) const
+        {
+            return m_min.x <= point.x and m_min.y <= point.y and m_min.z <= point.z
+               and point.x <= m_max.x and point.y <= m_max.y and point.z <= m_max.z;
+        }
+
+        bool contains(const Aabb& other) const
+        {
+            return m_min.x <= other.m_min.x and m_min.y <= other.m_min.y and m_min.z <= other.m_min.z
+               and other.m_max.x <= m_max.x and other.m_max.y <= m_max.y and other.m_max.z <= m_max.z;
+        }
+
+        // the cost metric of the hierarchy, how likely a random ray or volume is to hit the box
+        float surface_area() const
+        {
+            auto size = m_max - m_min;
+            return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+
+        Aabb fattened(float margin) const
+        {
+            auto grow = glm::vec3{ margin };
+            return { m_min - grow, m_max + grow };
+        }
+    };
+
+    inline Aabb merge(const Aabb& lhs, const Aabb& rhs)
+    {
+        return { glm::min(lhs.m_min, rhs.m_min), glm::max(lhs.m_max, rhs.m_max) };
+    }
+
+    // touching counts as overlapping
+    inline bool overlap(const Aabb& lhs, const Aabb& rhs)
+    {
+        return lhs.m_min.x <= rhs.m_max.x and rhs.m_min.x <= lhs.m_max.x
+           and lhs.m_min.y <= rhs.m_max.y and rhs.m_min.y <= lhs.m_max.y
+           and lhs.m_min.z <= rhs.m_max.z and rhs.m_min.z <= lhs.m_max.z;
+    }
+
+    /**
+     * @brief Bounds of a unit cube centered at `position` and scaled by `scale`, under any rotation.
+     *
+     * The bounds of the sphere around the cube, so rotating never changes them.
+     */
+    inline Aabb cube_bounds(glm::vec3 position, glm::vec3 scale)
+    {
+        auto radius = glm::vec3{ 0.5f * glm::length(scale) };
+        return { position - radius, position + radius };
+    }
+}
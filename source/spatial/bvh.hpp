@@ -0,0 +1,360 @@
+#pragma once
+
+#include "spatial/aabb.hpp"
+#include "spatial/frustum.hpp"
+
+#include <ecs/common.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace nexus::spatial
+{
+    /**
+     * @brief A dynamic bounding volume hierarchy of entities.
+     *
+     * Leaves store fattened bounds, so an entity that moves a little stays inside its leaf and the tree is
+     * left untouched; only the ones leaving their fat bounds are removed and reinserted. Insertion picks the
+     * sibling that grows the surface area of the tree the least, and every ancestor of a changed node is
+     * rebalanced with tree rotations, like Box2D's dynamic tree.
+     */
+    class Bvh
+    {
+    public:
+        using Proxy = std::int32_t;
+
+        static constexpr Proxy null = -1;
+
+        /**
+         * @param margin How much the bounds of a leaf are grown past the bounds of its entity.
+         */
+        explicit Bvh(float margin)
+            : m_margin{ margin }
+        {
+        }
+
+        Proxy insert(ecs::Entity entity, const Aabb& bounds)
+        {
+            auto leaf = allocate();
+
+            m_nodes[leaf].m_bounds = bounds.fattened(m_margin);
+            m_nodes[leaf].m_entity = entity;
+
+            insert_leaf(leaf);
+            ++m_leaf_count;
+
+            return leaf;
+        }
+
+        void remove(Proxy proxy)
+        {
+            assert(is_leaf(proxy));
+
+            remove_leaf(proxy);
+            deallocate(proxy);
+            --m_leaf_count;
+        }
+
+        /**
+         * @brief Update the bounds of an entity.
+         *
+         * @return Whether the entity left its fat bounds and was reinserted.
+         */
+        bool move(Proxy proxy, const Aabb& bounds)
+        {
+            assert(is_leaf(proxy));
+
+            if (m_nodes[proxy].m_bounds.contains(bounds)) {
+                return false;
+            }
+
+            remove_leaf(proxy);
+            m_nodes[proxy].m_bounds = bounds.fattened(m_margin);
+            insert_leaf(proxy);
+
+            return true;
+        }
+
+        /**
+         * @brief Invoke `fn(entity)` for every entity whose fat bounds are at least partly inside a frustum.
+         *
+         * The planes are not tested below a node that is entirely inside the frustum.
+         *
+         * @return The number of nodes visited.
+         */
+        template <std::invocable<ecs::Entity> Fn>
+        std::size_t query(const Frustum& frustum, Fn&& fn)
+        {
+            auto visited = 0uz;
+            if (m_root == null) {
+                return visited;
+            }
+
+            // the high bit of a stack entry marks a node known to be inside
+            constexpr auto inside_bit = std::uint32_t{ 1 } << 31;
+
+            m_stack.clear();
+            m_stack.push_back(static_cast<std::uint32_t>(m_root));
+
+            while (not m_stack.empty()) {
+                auto entry = m_stack.back();
+                m_stack.pop_back();
+                ++visited;
+
+                auto        index  = static_cast<Proxy>(entry & ~inside_bit);
+                const auto& node   = m_nodes[index];
+                auto        inside = (entry & inside_bit) != 0;
+
+                if (not inside) {
+                    auto visibility = frustum.test(node.m_bounds);
+                    if (visibility == Visibility::Outside) {
+                        continue;
+                    }
+                    inside = visibility == Visibility::Inside;
+                }
+
+                if (node.is_leaf()) {
+                    fn(node.m_entity);
+                    continue;
+                }
+
+                auto flag = inside ? inside_bit : 0;
+                m_stack.push_back(static_cast<std::uint32_t>(node.m_left) | flag);
+                m_stack.push_back(static_cast<std::uint32_t>(node.m_right) | flag);
+            }
+
+            return visited;
+        }
+
+        ecs::Entity entity(Proxy proxy) const { return m_nodes[proxy].m_entity; }
+        const Aabb& fat_bounds(Proxy proxy) const { return m_nodes[proxy].m_bounds; }
+
+        std::size_t size() const { return m_leaf_count; }
+        int         height() const { return m_root == null ? 0 : m_nodes[m_root].m_height; }
+
+    private:
+        struct Node
+        {
+            Aabb        m_bounds = {};
+            ecs::Entity m_entity = ecs::Entity{ 0 };
+            Proxy       m_parent = null;    // the next free node while not in use
+            Proxy       m_left   = null;
+            Proxy       m_right  = null;
+            int         m_height = 0;    // 0 for leaves, -1 while not in use
+
+            bool is_leaf() const { return m_left == null; }
+        };
+
+        bool is_leaf(Proxy proxy) const
+        {
+            return proxy >= 0 and static_cast<std::size_t>(proxy) < m_nodes.size()
+               and m_nodes[proxy].m_height == 0;
+        }
+
+        Proxy allocate()
+        {
+            if (m_free == null) {
+                m_nodes.emplace_back();
+                return static_cast<Proxy>(m_nodes.size() - 1);
+            }
+
+            auto index = std::exchange(m_free, m_nodes[m_free].m_parent);
+            m_nodes[index] = Node{};
+            return index;
+        }
+
+        void deallocate(Proxy index)
+        {
+            m_nodes[index].m_parent = std::exchange(m_free, index);
+            m_nodes[index].m_height = -1;
+        }
+
+        void insert_leaf(Proxy leaf)
+        {
+            if (m_root == null) {
+                m_root                 = leaf;
+                m_nodes[leaf].m_parent = null;
+                return;
+            }
+
+            // descend towards the cheapest sibling, the cost being the surface area added to the tree
+            auto bounds = m_nodes[leaf].m_bounds;
+            auto index  = m_root;
+
+            while (not m_nodes[index].is_leaf()) {
+                const auto& node = m_nodes[index];
+
+                auto area     = node.m_bounds.surface_area();
+                auto combined = merge(node.m_bounds, bounds).surface_area();
+
+                // pairing with this node makes a new parent, descending pushes its bounds onto every child
+                auto cost        = 2.0f * combined;
+                auto inheritance = 2.0f * (combined - area);
+
+                auto child_cost = [&](Proxy child) {
+                    const auto& child_bounds = m_nodes[child].m_bounds;
+                    auto        grown        = merge(child_bounds, bounds).surface_area();
+                    if (m_nodes[child].is_leaf()) {
+                        return grown + inheritance;
+                    }
+                    return grown - child_bounds.surface_area() + inheritance;
+                };
+
+                auto left_cost  = child_cost(node.m_left);
+                auto right_cost = child_cost(node.m_right);
+
+                if (cost < left_cost and cost < right_cost) {
+                    break;
+                }
+
+                index = left_cost < right_cost ? node.m_left : node.m_right;
+            }
+
+            auto sibling    = index;
+            auto old_parent = m_nodes[sibling].m_parent;
+            auto new_parent = allocate();
+
+            auto& parent    = m_nodes[new_parent];
+            parent.m_parent = old_parent;
+            parent.m_bounds = merge(bounds, m_nodes[sibling].m_bounds);
+            parent.m_height = m_nodes[sibling].m_height + 1;
+            parent.m_left   = sibling;
+            parent.m_right  = leaf;
+
+            if (old_parent == null) {
+                m_root = new_parent;
+            } else if (m_nodes[old_parent].m_left == sibling) {
+                m_nodes[old_parent].m_left = new_parent;
+            } else {
+                m_nodes[old_parent].m_right = new_parent;
+            }
+
+            m_nodes[sibling].m_parent = new_parent;
+            m_nodes[leaf].m_parent    = new_parent;
+
+            refit(m_nodes[leaf].m_parent);
+        }
+
+        void remove_leaf(Proxy leaf)
+        {
+            if (leaf == m_root) {
+                m_root = null;
+                return;
+            }
+
+            auto parent      = m_nodes[leaf].m_parent;
+            auto grandparent = m_nodes[parent].m_parent;
+            auto sibling     = m_nodes[parent].m_left == leaf ? m_nodes[parent].m_right
+                                                              : m_nodes[parent].m_left;
+
+            // the sibling takes the place of the parent
+            if (grandparent == null) {
+                m_root = sibling;
+            } else if (m_nodes[grandparent].m_left == parent) {
+                m_nodes[grandparent].m_left = sibling;
+            } else {
+                m_nodes[grandparent].m_right = sibling;
+            }
+
+            m_nodes[sibling].m_parent = grandparent;
+            deallocate(parent);
+
+            refit(grandparent);
+        }
+
+        // recompute the bounds and heights from a node up to the root, rebalancing along the way
+        void refit(Proxy index)
+        {
+            while (index != null) {
+                index = balance(index);
+
+                auto& node = m_nodes[index];
+                update(node);
+
+                index = node.m_parent;
+            }
+        }
+
+        void update(Node& node)
+        {
+            const auto& left  = m_nodes[node.m_left];
+            const auto& right = m_nodes[node.m_right];
+
+            node.m_bounds = merge(left.m_bounds, right.m_bounds);
+            node.m_height = 1 + std::max(left.m_height, right.m_height);
+        }
+
+        /**
+         * @brief Rotate the taller child of a node up if the heights of its children differ by more than one.
+         *
+         * @return The node now at the position of `a`.
+         */
+        Proxy balance(Proxy a)
+        {
+            if (m_nodes[a].is_leaf() or m_nodes[a].m_height < 2) {
+                return a;
+            }
+
+            auto b = m_nodes[a].m_left;
+            auto c = m_nodes[a].m_right;
+
+            auto difference = m_nodes[c].m_height - m_nodes[b].m_height;
+            if (difference > 1) {
+                return rotate(a, c, b);
+            }
+            if (difference < -1) {
+                return rotate(a, b, c);
+            }
+            return a;
+        }
+
+        // promote `up`, the taller child of `a`, keeping `a` as its child along with one of its children
+        Proxy rotate(Proxy a, Proxy up, Proxy other)
+        {
+            auto& node_a  = m_nodes[a];
+            auto& node_up = m_nodes[up];
+
+            auto f = node_up.m_left;
+            auto g = node_up.m_right;
+
+            // `up` takes the place of `a`
+            node_up.m_left   = a;
+            node_up.m_parent = std::exchange(node_a.m_parent, up);
+
+            if (node_up.m_parent == null) {
+                m_root = up;
+            } else if (m_nodes[node_up.m_parent].m_left == a) {
+                m_nodes[node_up.m_parent].m_left = up;
+            } else {
+                m_nodes[node_up.m_parent].m_right = up;
+            }
+
+            // the taller grandchild stays under `up`, the other one replaces `up` under `a`
+            auto [keep, give] = m_nodes[f].m_height > m_nodes[g].m_height ? std::pair{ f, g }
+                                                                          : std::pair{ g, f };
+
+            node_up.m_right        = keep;
+            m_nodes[give].m_parent = a;
+
+            node_a.m_left  = other;
+            node_a.m_right = give;
+
+            update(node_a);
+            update(node_up);
+
+            return up;
+        }
+
+        std::vector<Node>          m_nodes;
+        std::vector<std::uint32_t> m_stack;    // of the traversal, kept to reuse its allocation
+
+        Proxy       m_root       = null;
+        Proxy       m_free       = null;
+        std::size_t m_leaf_count = 0;
+        float       m_margin;
+    };
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "spatial/aabb.hpp"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <array>
+
+namespace nexus::spatial
+{
+    enum class Visibility
+    {
+        Outside,
+        Intersecting,
+        Inside,
+    };
+
+    /**
+     * @brief The six planes bounding what a camera sees, facing inwards.
+     */
+    struct Frustum
+    {
+        // a plane as (normal, distance): a point p is in front of it when dot(normal, p) + distance >= 0
+        std::array<glm::vec4, 6> m_planes;
+
+        /**
+         * @brief Extract the planes from a view-projection matrix (Gribb-Hartmann).
+         *
+         * Each plane is the sum or difference of the last row of the matrix and one of the others, for OpenGL
+         * clip space where every coordinate is in [-w, w].
+         */
+        static Frustum from(const glm::mat4& view_projection)
+        {
+            auto row = [&](int i) {
+                const auto& m = view_projection;
+                return glm::vec4{ m[0][i], m[1][i], m[2][i], m[3][i] };
+            };
+
+            auto frustum = Frustum{ {
+                row(3) + row(0),    // left
+                row(3) - row(0),    // right
+                row(3) + row(1),    // bottom
+                row(3) - row(1),    // top
+                row(3) + row(2),    // near
+                row(3) - row(2),    // far
+            } };
+
+            for (auto& plane : frustum.m_planes) {
+                plane /= glm::length(glm::vec3{ plane });
+            }
+
+            return frustum;
+        }
+
+        Visibility test(const Aabb& aabb) const
+        {
+            auto center = aabb.center();
+            auto extent = aabb.extent();
+            auto result = Visibility::Inside;
+
+            for (const auto& plane : m_planes) {
+                auto normal = glm::vec3{ plane };
+
+                // signed distance of the center, and the box's half-size projected onto the normal
+                auto distance = glm::dot(normal, center) + plane.w;
+                auto radius   = glm::dot(glm::abs(normal), extent);
+
+                if (distance + radius < 0.0f) {
+                    return Visibility::Outside;
+                }
+                if (distance - radius < 0.0f) {
+                    result = Visibility::Intersecting;
+                }
+            }
+
+            return result;
+        }
+    };
+}
@@ -0,0 +1,340 @@
+#pragma once
+
+#include "spatial/aabb.hpp"
+
+#include <ecs/common.hpp>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+namespace nexus::spatial
+{
+    struct Sphere
+    {
+        glm::vec3 m_center;
+        float     m_radius;
+
+        Aabb bounds() const
+        {
+            auto radius = glm::vec3{ m_radius };
+            return { m_center - radius, m_center + radius };
+        }
+
+        bool contains(glm::vec3 point) const
+        {
+            auto offset = point - m_center;
+            return glm::dot(offset, offset) <= m_radius * m_radius;
+        }
+    };
+
+    /**
+     * @brief A uniform grid of entity positions, the cells hashed so that only occupied ones take memory.
+     *
+     * Each cell is an intrusive doubly linked list threaded through the entries, which are indexed by entity
+     * index, so moving an entity to another cell is a constant time unlink and link. Queries only visit the
+     * cells overlapping the queried shape and don't allocate.
+     */
+    class HashGrid
+    {
+    public:
+        using Index = std::int32_t;
+
+        static constexpr Index null = -1;
+
+        // cell coordinates stay within this of zero, so that they convert from floats exactly and a query can
+        // step one past the last cell without overflowing
+        static constexpr std::int32_t max_cell = std::int32_t{ 1 } << 30;
+
+        // integer coordinates of a cell
+        struct Cell
+        {
+            std::int32_t m_x, m_y, m_z;
+
+            bool operator==(const Cell&) const = default;
+        };
+
+        /**
+         * @brief Entities of the grid inside a shape, as a lazy range.
+         *
+         * Invalidated by any change to the grid.
+         */
+        template <typename Shape>
+        class Query
+        {
+        public:
+            class Iterator
+            {
+            public:
+                using value_type      = ecs::Entity;
+                using difference_type = std::ptrdiff_t;
+
+                Iterator() = default;
+
+                Iterator(const HashGrid& grid, const Shape& shape, Cell min, Cell max)
+                    : m_grid{ &grid }
+                    , m_shape{ shape }
+                    , m_min{ min }
+                    , m_max{ max }
+                    , m_cell{ min }
+                    , m_entry{ grid.head(min) }
+                {
+                    advance();
+                }
+
+                ecs::Entity operator*() const { return m_grid->m_entries[m_entry].m_entity; }
+
+                Iterator& operator++()
+                {
+                    m_entry = m_grid->m_entries[m_entry].m_next;
+                    advance();
+                    return *this;
+                }
+
+                Iterator operator++(int)
+                {
+                    auto copy = *this;
+                    ++*this;
+                    return copy;
+                }
+
+                bool operator==(std::default_sentinel_t) const { return m_entry == null; }
+
+            private:
+                // skip to the next entry inside the shape, moving through the cells as they run out
+                void advance()
+                {
+                    while (true) {
+                        for (; m_entry != null; m_entry = m_grid->m_entries[m_entry].m_next) {
+                            if (m_shape.contains(m_grid->m_entries[m_entry].m_position)) {
+                                return;
+                            }
+                        }
+                        if (not next_cell()) {
+                            return;
+                        }
+                        m_entry = m_grid->head(m_cell);
+                    }
+                }
+
+                bool next_cell()
+                {
+                    if (++m_cell.m_x <= m_max.m_x) {
+                        return true;
+                    }
+                    m_cell.m_x = m_min.m_x;
+                    if (++m_cell.m_y <= m_max.m_y) {
+                        return true;
+                    }
+                    m_cell.m_y = m_min.m_y;
+                    return ++m_cell.m_z <= m_max.m_z;
+                }
+
+                const HashGrid* m_grid  = nullptr;
+                Shape           m_shape = {};
+                Cell            m_min   = {};
+                Cell            m_max   = {};
+                Cell            m_cell  = {};
+                Index           m_entry = null;
+            };
+
+            Query(const HashGrid& grid, const Shape& shape)
+                : m_grid{ &grid }
+                , m_shape{ shape }
+            {
+            }
+
+            Iterator begin() const
+            {
+                auto bounds = m_shape.bounds();
+                return { *m_grid, m_shape, m_grid->cell_of(bounds.m_min), m_grid->cell_of(bounds.m_max) };
+            }
+
+            std::default_sentinel_t end() const { return {}; }
+
+        private:
+            const HashGrid* m_grid;
+            Shape           m_shape;
+        };
+
+        /**
+         * @param cell_size The side length of a cell, around the usual query radius works best.
+         */
+        explicit HashGrid(float cell_size)
+            : m_inv_cell_size{ 1.0f / cell_size }
+        {
+            assert(cell_size > 0.0f);
+        }
+
+        /**
+         * @brief Insert an entity or update its position.
+         *
+         * An entity that reuses the slot of another one replaces it.
+         */
+        void update(ecs::Entity entity, glm::vec3 position)
+        {
+            auto index = static_cast<std::size_t>(entity.index());
+            if (index >= m_entries.size()) {
+                m_entries.resize(index + 1);
+            }
+
+            auto& entry = m_entries[index];
+            auto  cell  = cell_of(position);
+
+            entry.m_entity   = entity;
+            entry.m_position = position;
+
+            if (entry.m_present and entry.m_cell == cell) {
+                return;
+            }
+
+            if (entry.m_present) {
+                unlink(static_cast<Index>(index));
+            } else {
+                entry.m_present = true;
+                ++m_size;
+            }
+
+            entry.m_cell = cell;
+            link(static_cast<Index>(index));
+        }
+
+        void remove(ecs::Entity entity)
+        {
+            if (not contains(entity)) {
+                return;
+            }
+
+            auto index = static_cast<Index>(entity.index());
+            unlink(index);
+            m_entries[static_cast<std::size_t>(index)].m_present = false;
+            --m_size;
+        }
+
+        bool contains(ecs::Entity entity) const
+        {
+            auto index = static_cast<std::size_t>(entity.index());
+            return index < m_entries.size() and m_entries[index].m_present
+               and m_entries[index].m_entity == entity;
+        }
+
+        /**
+         * @brief Remove every entity for which `pred(entity)` is true.
+         */
+        template <std::predicate<ecs::Entity> Pred>
+        void remove_if(Pred&& pred)
+        {
+            for (auto index = 0uz; index < m_entries.size(); ++index) {
+                auto& entry = m_entries[index];
+                if (entry.m_present and pred(entry.m_entity)) {
+                    unlink(static_cast<Index>(index));
+                    entry.m_present = false;
+                    --m_size;
+                }
+            }
+        }
+
+        // the entities within `radius` of `center`
+        Query<Sphere> query_radius(glm::vec3 center, float radius) const
+        {
+            assert(radius >= 0.0f and "Negative query radius");
+            return { *this, Sphere{ center, radius } };
+        }
+
+        // the entities inside `aabb`, boundary included
+        Query<Aabb> query_aabb(const Aabb& aabb) const { return { *this, aabb }; }
+
+        // positions beyond the outermost cells fall into them, and NaN coordinates into cell 0
+        Cell cell_of(glm::vec3 position) const
+        {
+            constexpr auto limit = static_cast<float>(max_cell);
+
+            auto scaled     = glm::floor(position * m_inv_cell_size);
+            auto coordinate = [&](float value) {
+                return std::isnan(value) ? 0 : static_cast<std::int32_t>(std::clamp(value, -limit, limit));
+            };
+
+            return { coordinate(scaled.x), coordinate(scaled.y), coordinate(scaled.z) };
+        }
+
+        std::size_t size() const { return m_size; }
+        std::size_t cell_count() const { return m_cells.size(); }
+
+    private:
+        struct Entry
+        {
+            ecs::Entity m_entity   = ecs::Entity{ 0 };
+            glm::vec3   m_position = {};
+            Cell        m_cell     = {};
+            Index       m_prev     = null;
+            Index       m_next     = null;
+            bool        m_present  = false;
+        };
+
+        // large primes, from "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+        struct CellHash
+        {
+            std::size_t operator()(const Cell& cell) const
+            {
+                auto x = static_cast<std::uint32_t>(cell.m_x) * 73856093u;
+                auto y = static_cast<std::uint32_t>(cell.m_y) * 19349663u;
+                auto z = static_cast<std::uint32_t>(cell.m_z) * 83492791u;
+                return x ^ y ^ z;
+            }
+        };
+
+        Index head(const Cell& cell) const
+        {
+            auto found = m_cells.find(cell);
+            return found != m_cells.end() ? found->second : null;
+        }
+
+        void link(Index index)
+        {
+            auto& entry = m_entries[static_cast<std::size_t>(index)];
+            auto& head  = m_cells.try_emplace(entry.m_cell, null).first->second;
+
+            entry.m_prev = null;
+            entry.m_next = head;
+            if (head != null) {
+                m_entries[static_cast<std::size_t>(head)].m_prev = index;
+            }
+            head = index;
+        }
+
+        // empty cells are dropped so that a query never walks through cells nothing lives in anymore
+        void unlink(Index index)
+        {
+            auto& entry = m_entries[static_cast<std::size_t>(index)];
+
+            if (entry.m_next != null) {
+                m_entries[static_cast<std::size_t>(entry.m_next)].m_prev = entry.m_prev;
+            }
+
+            if (entry.m_prev != null) {
+                m_entries[static_cast<std::size_t>(entry.m_prev)].m_next = entry.m_next;
+            } else if (entry.m_next != null) {
+                m_cells.find(entry.m_cell)->second = entry.m_next;
+            } else {
+                m_cells.erase(entry.m_cell);
+            }
+
+            entry.m_prev = entry.m_next = null;
+        }
+
+        std::unordered_map<Cell, Index, CellHash> m_cells;      // to the first entry in the cell
+        std::vector<Entry>                        m_entries;    // by entity index
+        std::size_t                               m_size = 0;
+        float                                     m_inv_cell_size;
+    };
+}
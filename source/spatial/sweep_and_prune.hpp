@@ -0,0 +1,213 @@
+#pragma once
+
+#include "spatial/aabb.hpp"
+
+#include <ecs/common.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace nexus::spatial
+{
+    /**
+     * @brief Sweep-and-prune broadphase: finds the pairs of entities whose bounds overlap.
+     *
+     * The intervals of the bounds along one axis are kept sorted across updates. Bodies barely move between
+     * frames, so the list is nearly sorted already and an insertion sort fixes it in about linear time.
+     * Sweeping the sorted list only tests bodies whose intervals overlap on that axis. The axis is the one
+     * along which the centers vary the most, which spreads the intervals out the most; when it changes the
+     * list is sorted from scratch.
+     */
+    class SweepAndPrune
+    {
+    public:
+        struct Pair
+        {
+            ecs::Entity m_first;
+            ecs::Entity m_second;
+        };
+
+        /**
+         * @brief Update the bounds of the bodies and find the overlapping pairs.
+         *
+         * Entities missing from an update are dropped. The pairs are written into a buffer that is reused
+         * across updates, so the span returned by `pairs()` is invalidated by the next one.
+         *
+         * @param entities The bodies, each at most once.
+         * @param bounds The bounds of each entity, in the same order.
+         */
+        void update(std::span<const ecs::Entity> entities, std::span<const Aabb> bounds)
+        {
+            assert(entities.size() == bounds.size());
+
+            ++m_frame;
+
+            auto added = 0uz;
+            for (auto i = 0uz; i < entities.size(); ++i) {
+                auto index = static_cast<std::size_t>(entities[i].index());
+                if (index >= m_bodies.size()) {
+                    m_bodies.resize(index + 1);
+                }
+
+                auto& body = m_bodies[index];
+                if (body.m_last_seen == 0) {
+                    m_intervals.push_back({ .m_body = static_cast<std::uint32_t>(index) });
+                    ++added;
+                }
+
+                body.m_entity    = entities[i];
+                body.m_bounds    = bounds[i];
+                body.m_last_seen = m_frame;
+            }
+
+            // bodies that are gone, slots reused by other entities are kept as they are updated above; the
+            // intervals of the added ones are still at the end
+            if (m_intervals.size() > entities.size()) {
+                std::erase_if(m_intervals, [&](const Interval& interval) {
+                    auto& body = m_bodies[interval.m_body];
+                    if (body.m_last_seen == m_frame) {
+                        return false;
+                    }
+                    body.m_last_seen = 0;
+                    return true;
+                });
+            }
+
+            auto axis   = axis_of_greatest_variance(bounds);
+            auto axis_1 = (axis + 1) % 3;
+            auto axis_2 = (axis + 2) % 3;
+
+            for (auto& interval : m_intervals) {
+                const auto& body = m_bodies[interval.m_body].m_bounds;
+
+                interval.m_min   = body.m_min[axis];
+                interval.m_max   = body.m_max[axis];
+                interval.m_min_1 = body.m_min[axis_1];
+                interval.m_max_1 = body.m_max[axis_1];
+                interval.m_min_2 = body.m_min[axis_2];
+                interval.m_max_2 = body.m_max[axis_2];
+            }
+
+            // the added bodies are sorted on their own and merged in, inserting them one by one would move
+            // half of the list each
+            if (axis == m_axis) {
+                auto middle = m_intervals.end() - static_cast<std::ptrdiff_t>(added);
+                insertion_sort({ m_intervals.begin(), middle });
+                std::ranges::sort(middle, m_intervals.end(), {}, &Interval::m_min);
+                std::ranges::inplace_merge(m_intervals, middle, {}, &Interval::m_min);
+            } else {
+                std::ranges::sort(m_intervals, {}, &Interval::m_min);
+                m_axis = axis;
+            }
+
+            sweep();
+        }
+
+        std::span<const Pair> pairs() const { return m_pairs; }
+
+        std::size_t size() const { return m_intervals.size(); }
+        int         axis() const { return m_axis; }
+
+        // number of element moves done by the insertion sort of the last update
+        std::size_t last_swaps() const { return m_swaps; }
+
+    private:
+        struct Body
+        {
+            ecs::Entity   m_entity    = ecs::Entity{ 0 };
+            Aabb          m_bounds    = {};
+            std::uint64_t m_last_seen = 0;    // 0 if not in the broadphase
+        };
+
+        // the bounds of a body with the sweep axis first, so the sweep reads the intervals in order only
+        struct Interval
+        {
+            float         m_min   = 0.0f;
+            float         m_max   = 0.0f;
+            float         m_min_1 = 0.0f;    // along the next axis
+            float         m_max_1 = 0.0f;
+            float         m_min_2 = 0.0f;    // and the one after
+            float         m_max_2 = 0.0f;
+            std::uint32_t m_body  = 0;
+        };
+
+        static int axis_of_greatest_variance(std::span<const Aabb> bounds)
+        {
+            if (bounds.empty()) {
+                return 0;
+            }
+
+            auto sum    = glm::vec3{ 0.0f };
+            auto sum_sq = glm::vec3{ 0.0f };
+            for (const auto& aabb : bounds) {
+                auto center  = aabb.center();
+                sum         += center;
+                sum_sq      += center * center;
+            }
+
+            auto count    = static_cast<float>(bounds.size());
+            auto mean     = sum / count;
+            auto variance = sum_sq / count - mean * mean;
+
+            if (variance.x >= variance.y and variance.x >= variance.z) {
+                return 0;
+            }
+            return variance.y >= variance.z ? 1 : 2;
+        }
+
+        void insertion_sort(std::span<Interval> intervals)
+        {
+            m_swaps = 0;
+            for (auto i = 1uz; i < intervals.size(); ++i) {
+                auto interval = intervals[i];
+                auto j        = i;
+                for (; j > 0 and intervals[j - 1].m_min > interval.m_min; --j) {
+                    intervals[j] = intervals[j - 1];
+                }
+                intervals[j]  = interval;
+                m_swaps      += i - j;
+            }
+        }
+
+        void sweep()
+        {
+            m_pairs.clear();
+
+            // hoisted, the pushes to the pairs would otherwise make them reload every iteration
+            const auto* intervals = m_intervals.data();
+            const auto  count     = m_intervals.size();
+
+            for (auto i = 0uz; i < count; ++i) {
+                const auto lhs = intervals[i];
+
+                for (auto j = i + 1; j < count and intervals[j].m_min <= lhs.m_max; ++j) {
+                    const auto& rhs = intervals[j];
+
+                    // whether the other axes overlap is close to a coin flip, so it is evaluated without
+                    // branching on each comparison
+                    auto overlaps = static_cast<int>(lhs.m_min_1 <= rhs.m_max_1)
+                                  & static_cast<int>(rhs.m_min_1 <= lhs.m_max_1)
+                                  & static_cast<int>(lhs.m_min_2 <= rhs.m_max_2)
+                                  & static_cast<int>(rhs.m_min_2 <= lhs.m_max_2);
+
+                    if (overlaps != 0) [[unlikely]] {
+                        m_pairs.push_back({ m_bodies[lhs.m_body].m_entity, m_bodies[rhs.m_body].m_entity });
+                    }
+                }
+            }
+        }
+
+        std::vector<Body>     m_bodies;       // by entity index
+        std::vector<Interval> m_intervals;    // sorted by their minimum along the axis
+        std::vector<Pair>     m_pairs;
+        std::uint64_t         m_frame = 0;
+        std::size_t           m_swaps = 0;
+        int                   m_axis  = -1;
+    };
+}
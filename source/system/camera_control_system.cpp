@@ -12,7 +12,7 @@ namespace nexus
 
     void CameraControlSystem::update(
         ecs_config::Coordinator&     context,
-        const std::set<ecs::Entity>& entities,
+        std::span<const ecs::Entity> entities,
         ecs::Duration                frame_time
     )
     {
@@ -82,7 +82,8 @@ namespace nexus
             }
 
             // rotate the displacement vector by the camera's rotation
-            transform.m_position += glm::vec3{ transform.m_rotation * displacement };
+            auto [position, scale, rotation] = transform;
+            position += glm::vec3{ rotation * displacement };
             // -----------
         }
     }
@@ -4,12 +4,14 @@
 
 #include <glfw_cpp/window.hpp>
 
+#include <span>
+
 namespace nexus
 {
     class CameraControlSystem final : public ecs_config::ISystem
     {
     public:
-        using Components = std::tuple<Camera, Transform>;
+        using Components = std::tuple<const Camera, Transform>;
 
         ~CameraControlSystem() override = default;
 
@@ -17,7 +19,7 @@ namespace nexus
 
         void update(
             ecs_config::Coordinator&     context,
-            const std::set<ecs::Entity>& entities,
+            std::span<const ecs::Entity> entities,
             ecs::Duration                frame_time
         ) override;
 
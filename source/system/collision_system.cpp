@@ -0,0 +1,27 @@
+#include "collision_system.hpp"
+
+#include <ecs/coordinator.hpp>
+
+namespace nexus
+{
+    void CollisionSystem::update(
+        ecs_config::Coordinator&     context,
+        std::span<const ecs::Entity> entities,
+        ecs::Duration /* frame_time */
+    )
+    {
+        m_bounds.resize(entities.size());
+
+        context.par_for(entities.size(), [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                auto transform = context.get_component<const Transform>(entities[i]);
+                auto position  = transform.get<&Transform::m_position>();
+                auto scale     = transform.get<&Transform::m_scale>();
+
+                m_bounds[i] = spatial::cube_bounds(position, scale);
+            }
+        });
+
+        m_broadphase.update(entities, m_bounds);
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "component/rigid_body.hpp"
+#include "component/transform.hpp"
+#include "spatial/sweep_and_prune.hpp"
+#include "ecs_config.hpp"
+
+#include <span>
+#include <tuple>
+#include <vector>
+
+namespace nexus
+{
+    /**
+     * @brief Broadphase collision detection of the rigid bodies, by sweep-and-prune.
+     *
+     * Only finds the pairs of bodies whose bounds overlap; responding to them is up to the systems reading
+     * `pairs()` after this one.
+     */
+    class CollisionSystem final : public ecs_config::ISystem
+    {
+    public:
+        using Components = std::tuple<const RigidBody, const Transform>;
+
+        CollisionSystem()           = default;
+        ~CollisionSystem() override = default;
+
+        void update(
+            ecs_config::Coordinator&     context,
+            std::span<const ecs::Entity> entities,
+            ecs::Duration                frame_time
+        ) override;
+
+        // the overlapping pairs of the last update
+        std::span<const spatial::SweepAndPrune::Pair> pairs() const { return m_broadphase.pairs(); }
+
+    private:
+        spatial::SweepAndPrune     m_broadphase;
+        std::vector<spatial::Aabb> m_bounds;
+    };
+}
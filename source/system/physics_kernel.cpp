@@ -0,0 +1,223 @@
+#include "physics_kernel.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__x86_64__) or defined(__i386__)
+#    define NEXUS_PHYSICS_X86 1
+#    include <immintrin.h>
+#else
+#    define NEXUS_PHYSICS_X86 0
+#endif
+
+// the helpers below are only ever inlined into the flattened kernel of their width's instruction set, so the
+// ABI of passing wide vectors to functions built without it never comes into play
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace
+{
+    using nexus::physics::Bodies;
+
+    // a vector of `Lanes` floats, a plain float for a single lane
+    template <std::size_t Lanes>
+    struct VecOf
+    {
+        using Type [[gnu::vector_size(Lanes * sizeof(float))]] = float;
+    };
+
+    template <>
+    struct VecOf<1>
+    {
+        using Type = float;
+    };
+
+    template <std::size_t Lanes>
+    using Vec = typename VecOf<Lanes>::Type;
+
+    template <std::size_t Lanes>
+    inline Vec<Lanes> load(const float* from)
+    {
+        auto vec = Vec<Lanes>{};
+        std::memcpy(&vec, from, sizeof(vec));
+        return vec;
+    }
+
+    template <std::size_t Lanes>
+    inline void store(float* to, Vec<Lanes> vec)
+    {
+        std::memcpy(to, &vec, sizeof(vec));
+    }
+
+    template <std::size_t Lanes>
+    inline Vec<Lanes> splat(float value)
+    {
+        return Vec<Lanes>{} + value;
+    }
+
+    // vector extensions have no square root, each width uses the instruction of its set
+    inline float sqrt(float value)
+    {
+        return std::sqrt(value);
+    }
+
+#if NEXUS_PHYSICS_X86
+    inline Vec<4> sqrt(Vec<4> value)
+    {
+        return _mm_sqrt_ps(value);
+    }
+
+    [[gnu::target("avx2,fma")]] inline Vec<8> sqrt(Vec<8> value)
+    {
+        return _mm256_sqrt_ps(value);
+    }
+
+    // the zero-masked form with every lane set, the plain one trips -Wmaybe-uninitialized in older GCC headers
+    [[gnu::target("avx512f")]] inline Vec<16> sqrt(Vec<16> value)
+    {
+        return _mm512_maskz_sqrt_ps(0xffff, value);
+    }
+#endif
+
+    /**
+     * @brief Integrate `Lanes` consecutive bodies starting from `first`.
+     *
+     * Each coordinate is loaded into a vector of `Lanes` bodies, so every operation below integrates all of
+     * them at once using the instruction set of the caller.
+     */
+    template <std::size_t Lanes>
+    inline void integrate_block(const Bodies& bodies, std::size_t first, float dt)
+    {
+        auto half_dt = 0.5f * dt;
+
+        // translation
+        for (auto c = 0uz; c < 3; ++c) {
+            auto position = load<Lanes>(bodies.m_position[c] + first);
+            auto velocity = load<Lanes>(bodies.m_velocity[c] + first);
+
+            position += velocity * dt;
+            velocity += load<Lanes>(bodies.m_acceleration[c] + first) * dt;
+            velocity += load<Lanes>(bodies.m_gravity[c] + first) * dt;
+
+            store<Lanes>(bodies.m_position[c] + first, position);
+            store<Lanes>(bodies.m_velocity[c] + first, velocity);
+        }
+
+        // rotation: q + q * (0, w) * 0.5 * dt, then normalized
+        auto qw = load<Lanes>(bodies.m_rotation[0] + first);
+        auto qx = load<Lanes>(bodies.m_rotation[1] + first);
+        auto qy = load<Lanes>(bodies.m_rotation[2] + first);
+        auto qz = load<Lanes>(bodies.m_rotation[3] + first);
+
+        auto wx = load<Lanes>(bodies.m_angular_velocity[0] + first);
+        auto wy = load<Lanes>(bodies.m_angular_velocity[1] + first);
+        auto wz = load<Lanes>(bodies.m_angular_velocity[2] + first);
+
+        auto rw = qw + (-qx * wx - qy * wy - qz * wz) * half_dt;
+        auto rx = qx + (qw * wx + qy * wz - qz * wy) * half_dt;
+        auto ry = qy + (qw * wy + qz * wx - qx * wz) * half_dt;
+        auto rz = qz + (qw * wz + qx * wy - qy * wx) * half_dt;
+
+        // like glm, a degenerate quaternion normalizes to the identity
+        auto len      = sqrt(rw * rw + rx * rx + ry * ry + rz * rz);
+        auto inv_len  = 1.0f / len;
+        auto positive = len > 0.0f;
+        auto zero     = splat<Lanes>(0.0f);
+
+        store<Lanes>(bodies.m_rotation[0] + first, positive ? rw * inv_len : splat<Lanes>(1.0f));
+        store<Lanes>(bodies.m_rotation[1] + first, positive ? rx * inv_len : zero);
+        store<Lanes>(bodies.m_rotation[2] + first, positive ? ry * inv_len : zero);
+        store<Lanes>(bodies.m_rotation[3] + first, positive ? rz * inv_len : zero);
+    }
+
+    // whole blocks of `Lanes` bodies, then the remainder one at a time
+    template <std::size_t Lanes>
+    inline void integrate(const Bodies& bodies, float dt)
+    {
+        auto first = 0uz;
+        for (; first + Lanes <= bodies.m_count; first += Lanes) {
+            integrate_block<Lanes>(bodies, first, dt);
+        }
+        for (; first < bodies.m_count; ++first) {
+            integrate_block<1>(bodies, first, dt);
+        }
+    }
+
+    [[gnu::flatten]]
+    void integrate_scalar(const Bodies& bodies, float dt)
+    {
+        integrate<1>(bodies, dt);
+    }
+
+#if NEXUS_PHYSICS_X86
+    // SSE2 is part of the x86-64 baseline, so this one needs no target attribute
+    [[gnu::flatten]]
+    void integrate_sse(const Bodies& bodies, float dt)
+    {
+        integrate<4>(bodies, dt);
+    }
+
+    [[gnu::target("avx2,fma"), gnu::flatten]]
+    void integrate_avx2(const Bodies& bodies, float dt)
+    {
+        integrate<8>(bodies, dt);
+    }
+
+    [[gnu::target("avx512f"), gnu::flatten]]
+    void integrate_avx512(const Bodies& bodies, float dt)
+    {
+        integrate<16>(bodies, dt);
+    }
+#endif
+}
+
+namespace nexus::physics
+{
+    Kernel kernel(Isa isa)
+    {
+        switch (isa) {
+#if NEXUS_PHYSICS_X86
+        case Isa::Sse: return integrate_sse;
+        case Isa::Avx2: return integrate_avx2;
+        case Isa::Avx512: return integrate_avx512;
+#endif
+        default: return integrate_scalar;
+        }
+    }
+
+    bool is_supported(Isa isa)
+    {
+#if NEXUS_PHYSICS_X86
+        switch (isa) {
+        case Isa::Scalar: return true;
+        case Isa::Sse: return true;
+        case Isa::Avx2: return __builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma");
+        case Isa::Avx512: return __builtin_cpu_supports("avx512f");
+        }
+        return false;
+#else
+        return isa == Isa::Scalar;
+#endif
+    }
+
+    Isa detect_isa()
+    {
+        for (auto isa : { Isa::Avx512, Isa::Avx2, Isa::Sse }) {
+            if (is_supported(isa)) {
+                return isa;
+            }
+        }
+        return Isa::Scalar;
+    }
+
+    std::string_view name(Isa isa)
+    {
+        switch (isa) {
+        case Isa::Scalar: return "scalar";
+        case Isa::Sse: return "sse";
+        case Isa::Avx2: return "avx2";
+        case Isa::Avx512: return "avx512";
+        }
+        return "???";
+    }
+}
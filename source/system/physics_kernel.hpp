@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace nexus::physics
+{
+    /**
+     * @brief Bodies to integrate, every coordinate of every field in its own contiguous stream.
+     *
+     * The streams of a field are indexed by coordinate: x, y, z for vectors and w, x, y, z for the rotation.
+     */
+    struct Bodies
+    {
+        float*       m_position[3];
+        float*       m_velocity[3];
+        const float* m_acceleration[3];
+        const float* m_gravity[3];
+        const float* m_angular_velocity[3];
+        float*       m_rotation[4];
+
+        std::size_t m_count;
+    };
+
+    /**
+     * @brief Fixed-size streams to gather bodies into before integrating them.
+     */
+    template <std::size_t Capacity>
+    struct Streams
+    {
+        float m_position[3][Capacity];
+        float m_velocity[3][Capacity];
+        float m_acceleration[3][Capacity];
+        float m_gravity[3][Capacity];
+        float m_angular_velocity[3][Capacity];
+        float m_rotation[4][Capacity];
+
+        Bodies bodies(std::size_t count)
+        {
+            return {
+                .m_position         = { m_position[0], m_position[1], m_position[2] },
+                .m_velocity         = { m_velocity[0], m_velocity[1], m_velocity[2] },
+                .m_acceleration     = { m_acceleration[0], m_acceleration[1], m_acceleration[2] },
+                .m_gravity          = { m_gravity[0], m_gravity[1], m_gravity[2] },
+                .m_angular_velocity = { m_angular_velocity[0], m_angular_velocity[1], m_angular_velocity[2] },
+                .m_rotation         = { m_rotation[0], m_rotation[1], m_rotation[2], m_rotation[3] },
+                .m_count            = count,
+            };
+        }
+    };
+
+    // the instruction sets a kernel can be built for, from the narrowest
+    enum class Isa
+    {
+        Scalar,    // one body at a time
+        Sse,       // 4 bodies at a time
+        Avx2,      // 8 bodies at a time
+        Avx512,    // 16 bodies at a time
+    };
+
+    /**
+     * @brief Integrates the velocity, position, and rotation of the bodies over a time step.
+     *
+     * Every kernel matches the scalar one within `tolerance`: they do the same operations, but the wider ones
+     * may fuse multiplies and adds, which rounds differently.
+     */
+    using Kernel = void (*)(const Bodies& bodies, float dt);
+
+    // maximum difference of any coordinate from the scalar kernel after a single step, relative to the
+    // coordinate's magnitude (or absolute, below 1)
+    inline constexpr float tolerance = 1e-6f;
+
+    Kernel kernel(Isa isa);
+
+    // the widest instruction set supported by both the build and the running cpu
+    Isa detect_isa();
+
+    bool is_supported(Isa isa);
+
+    std::string_view name(Isa isa);
+}
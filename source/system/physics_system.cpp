@@ -2,30 +2,87 @@
 
 #include <ecs/coordinator.hpp>
 
-#include <print>
+#include <algorithm>
 
 namespace nexus
 {
+    PhysicsSystem::PhysicsSystem()
+        : m_isa{ physics::detect_isa() }
+        , m_kernel{ physics::kernel(m_isa) }
+    {
+    }
+
     void PhysicsSystem::update(
         ecs_config::Coordinator&     context,
-        const std::set<ecs::Entity>& entities,
+        std::span<const ecs::Entity> entities,
         ecs::Duration                frame_time
     )
     {
         auto dt = frame_time.count();
 
-        for (const auto& entity : entities) {
-            auto&& [gravity, rigidbody, transform] = context.get_component_tuple<Components>(entity);
+        // where the integrated fields of a gathered block are written back to
+        struct Targets
+        {
+            glm::vec3* m_position[block_size];
+            glm::vec3* m_velocity[block_size];
+            glm::quat* m_rotation[block_size];
+        };
+
+        auto process = [&](std::size_t begin, std::size_t end) {
+            auto streams = physics::Streams<block_size>{};
+            auto targets = Targets{};
+
+            for (auto first = begin; first < end; first += block_size) {
+                auto block = entities.subspan(first, std::min(block_size, end - first));
+
+                // gather, both components are stored field by field so the transform's scale is never loaded
+                for (auto i = 0uz; i < block.size(); ++i) {
+                    const auto& gravity   = context.get_component<const Gravity>(block[i]);
+                    auto        rigidbody = context.get_component<RigidBody>(block[i]);
+                    auto        transform = context.get_component<Transform>(block[i]);
+
+                    auto [velocity, acceleration, angular_velocity] = rigidbody;
+
+                    auto& position = transform.get<&Transform::m_position>();
+                    auto& rotation = transform.get<&Transform::m_rotation>();
+
+                    for (auto c = 0; c < 3; ++c) {
+                        streams.m_position[c][i]         = position[c];
+                        streams.m_velocity[c][i]         = velocity[c];
+                        streams.m_acceleration[c][i]     = acceleration[c];
+                        streams.m_gravity[c][i]          = gravity.m_force[c];
+                        streams.m_angular_velocity[c][i] = angular_velocity[c];
+                    }
+
+                    streams.m_rotation[0][i] = rotation.w;
+                    streams.m_rotation[1][i] = rotation.x;
+                    streams.m_rotation[2][i] = rotation.y;
+                    streams.m_rotation[3][i] = rotation.z;
+
+                    targets.m_position[i] = &position;
+                    targets.m_velocity[i] = &velocity;
+                    targets.m_rotation[i] = &rotation;
+                }
+
+                m_kernel(streams.bodies(block.size()), dt);
+
+                // scatter
+                for (auto i = 0uz; i < block.size(); ++i) {
+                    for (auto c = 0; c < 3; ++c) {
+                        (*targets.m_position[i])[c] = streams.m_position[c][i];
+                        (*targets.m_velocity[i])[c] = streams.m_velocity[c][i];
+                    }
 
-            // translation
-            transform.m_position += rigidbody.m_velocity * dt;
-            rigidbody.m_velocity += rigidbody.m_acceleration * dt;
-            rigidbody.m_velocity += gravity.m_force * dt;
+                    *targets.m_rotation[i] = glm::quat{
+                        streams.m_rotation[0][i],
+                        streams.m_rotation[1][i],
+                        streams.m_rotation[2][i],
+                        streams.m_rotation[3][i],
+                    };
+                }
+            }
+        };
 
-            // rotation
-            auto omega           = glm::quat{ 0.0f, rigidbody.m_angular_velocity };
-            auto quat_delta      = transform.m_rotation * omega * 0.5f * dt;
-            transform.m_rotation = glm::normalize(transform.m_rotation + quat_delta);
-        }
+        context.par_for(entities.size(), process);
     }
 }
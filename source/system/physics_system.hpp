@@ -3,28 +3,44 @@
 #include "component/gravity.hpp"
 #include "component/rigid_body.hpp"
 #include "component/transform.hpp"
+#include "system/physics_kernel.hpp"
 #include "ecs_config.hpp"
 
 #include <ecs/common.hpp>
 #include <ecs/concepts.hpp>
 
-#include <set>
+#include <span>
 #include <tuple>
 
 namespace nexus
 {
+    /**
+     * @brief Integrates every rigid body with the widest SIMD kernel the cpu supports.
+     *
+     * The bodies are gathered into per-coordinate streams a block at a time, integrated by the kernel, then
+     * scattered back into their components.
+     */
     class PhysicsSystem final : public ecs_config::ISystem
     {
     public:
-        using Components = std::tuple<Gravity, RigidBody, Transform>;
+        using Components = std::tuple<const Gravity, RigidBody, Transform>;
 
-        PhysicsSystem()           = default;
+        // number of bodies gathered at once, small enough for the streams to stay in L1
+        static constexpr std::size_t block_size = 128;
+
+        PhysicsSystem();
         ~PhysicsSystem() override = default;
 
         void update(
             ecs_config::Coordinator&     context,
-            const std::set<ecs::Entity>& entities,
+            std::span<const ecs::Entity> entities,
             ecs::Duration                frame_time
         ) override;
+
+        physics::Isa isa() const { return m_isa; }
+
+    private:
+        physics::Isa    m_isa;
+        physics::Kernel m_kernel;
     };
 }
@@ -10,6 +10,7 @@
 #include <glbinding/gl/gl.h>
 
 #include <print>
+#include <utility>
 
 namespace
 {
@@ -36,7 +37,11 @@ namespace nexus
         , m_camera{ coordinator.create_entity() }
         , m_cube{ 1.0f }
         , m_shader{ std::move(shader) }
+        , m_frame_uniforms{ frame_binding }
     {
+        m_instance_buffer.attach(m_cube.vao());
+        m_shader.bind_uniform_block("Frame", frame_binding);
+
         coordinator.add_component(
             m_camera,
             Transform{
@@ -53,7 +58,7 @@ namespace nexus
 
     void RenderSystem::update(
         ecs_config::Coordinator&     context,
-        const std::set<ecs::Entity>& entities,
+        std::span<const ecs::Entity> /* entities */,
         ecs::Duration /* frame_time */
     )
     {
@@ -66,31 +71,123 @@ namespace nexus
 
         m_shader.use();
 
-        const auto& [fov, near, far, speed, sensitivity] = context.get_component<Camera>(m_camera);
-        const auto& [cam_pos, cam_scale, cam_rot]        = context.get_component<Transform>(m_camera);
+        const auto& [fov, near, far, speed, sensitivity] = context.get_component<const Camera>(m_camera);
+        const auto& [cam_pos, cam_scale, cam_rot]        = context.get_component<const Transform>(m_camera);
 
         auto view       = view_matrix(cam_pos, cam_rot);
         auto projection = projection_matrix((float)width, (float)height, fov, near, far);
 
-        m_shader.set_uniform("u_view", view);
-        m_shader.set_uniform("u_projection", projection);
+        m_frame_uniforms.update({ .m_view = view, .m_projection = projection });
 
-        for (const auto& entity : entities) {
-            auto&& [renderable, transform] = context.get_component_tuple<Components>(entity);
+        auto entities = context.view<const Renderable, const Transform>().entities();
+        cull(context, entities, projection * view);
 
-            auto model = glm::translate(glm::mat4{ 1.0f }, transform.m_position);
-            model      = glm::scale(model, transform.m_scale);
-            model      = model * glm::mat4_cast(transform.m_rotation);
+        // building the instances doesn't need the GL context, so it is split across threads
+        m_instances.resize(m_visible.size());
 
-            m_shader.set_uniform("u_model", model);
-            m_shader.set_uniform("u_color", renderable.m_color);
+        context.par_for(m_visible.size(), [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                auto entity = m_visible[i];
 
-            m_cube.draw();
-        }
+                const auto& renderable                  = context.get_component<const Renderable>(entity);
+                const auto& [position, scale, rotation] = context.get_component<const Transform>(entity);
+
+                auto model = glm::translate(glm::mat4{ 1.0f }, position);
+                model      = glm::scale(model, scale);
+                model      = model * glm::mat4_cast(rotation);
+
+                m_instances[i] = { .m_model = model, .m_color = renderable.m_color };
+            }
+        });
+
+        m_instance_buffer.upload(m_instances);
+        m_cube.draw_instanced(m_instance_buffer.count());
 
         m_shader.unuse();
 
         m_render_context.display();
         m_render_context.unbind();
     }
+
+    void RenderSystem::cull(
+        ecs_config::Coordinator&     context,
+        std::span<const ecs::Entity> entities,
+        const glm::mat4&             view_projection
+    )
+    {
+        ++m_frame;
+
+        // the bounds of the entities whose transform changed since the last frame are computed in parallel,
+        // only updating the hierarchy is serial; rotating doesn't change them, so turning never moves an
+        // entity out of its leaf
+        auto since = last_run();
+
+        m_bounds.resize(entities.size());
+        m_moved.resize(entities.size());
+
+        context.par_for(entities.size(), [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                auto entity = entities[i];
+
+                m_moved[i] = context.component_ticks<Transform>(entity).changed_since(since);
+                if (m_moved[i]) {
+                    const auto& [position, scale, rotation] = context.get_component<const Transform>(entity);
+                    m_bounds[i] = spatial::cube_bounds(position, scale);
+                }
+            }
+        });
+
+        auto reinserted = 0uz;
+
+        for (auto i = 0uz; i < entities.size(); ++i) {
+            auto entity = entities[i];
+            auto index  = static_cast<std::size_t>(entity.index());
+
+            if (index >= m_proxies.size()) {
+                m_proxies.resize(index + 1, spatial::Bvh::null);
+                m_last_seen.resize(index + 1, 0);
+            }
+
+            auto& proxy = m_proxies[index];
+
+            // the slot may have been reused by another entity since the last frame
+            if (proxy != spatial::Bvh::null and m_bvh.entity(proxy) != entity) {
+                m_bvh.remove(std::exchange(proxy, spatial::Bvh::null));
+            }
+
+            if (proxy == spatial::Bvh::null) {
+                // e.g. a renderable added to an entity whose transform didn't change
+                if (not m_moved[i]) {
+                    const auto& [position, scale, rotation] = context.get_component<const Transform>(entity);
+                    m_bounds[i] = spatial::cube_bounds(position, scale);
+                }
+                proxy = m_bvh.insert(entity, m_bounds[i]);
+            } else if (m_moved[i] and m_bvh.move(proxy, m_bounds[i])) {
+                ++reinserted;
+            }
+
+            m_last_seen[index] = m_frame;
+        }
+
+        // entities that were destroyed or stopped being renderable
+        if (m_bvh.size() > entities.size()) {
+            for (auto index = 0uz; index < m_proxies.size(); ++index) {
+                if (m_proxies[index] != spatial::Bvh::null and m_last_seen[index] != m_frame) {
+                    m_bvh.remove(std::exchange(m_proxies[index], spatial::Bvh::null));
+                }
+            }
+        }
+
+        auto frustum = spatial::Frustum::from(view_projection);
+
+        m_visible.clear();
+        auto visited = m_bvh.query(frustum, [&](ecs::Entity entity) { m_visible.push_back(entity); });
+
+        m_culling_stats = {
+            .m_nodes_visited = visited,
+            .m_visible       = m_visible.size(),
+            .m_culled        = entities.size() - m_visible.size(),
+            .m_reinserted    = reinserted,
+        };
+    }
 }
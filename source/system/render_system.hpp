@@ -3,17 +3,45 @@
 #include "component/renderable.hpp"
 #include "component/transform.hpp"
 #include "graphics/cube_primitive.hpp"
+#include "graphics/instance_buffer.hpp"
 #include "graphics/shader.hpp"
+#include "graphics/uniform_buffer.hpp"
+#include "spatial/bvh.hpp"
 #include "ecs_config.hpp"
 
 #include <glfw_cpp/window.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
 
 namespace nexus
 {
+    struct CullingStats
+    {
+        std::size_t m_nodes_visited;    // of the hierarchy, while testing it against the frustum
+        std::size_t m_visible;
+        std::size_t m_culled;
+        std::size_t m_reinserted;    // entities that moved out of their fat bounds
+    };
+
+    /**
+     * @brief Draws every renderable cube in view with a single instanced draw call.
+     *
+     * The renderables are kept in a bounding volume hierarchy that is tested against the camera frustum
+     * every frame, so only the visible ones are turned into instances. Only the renderables whose transform
+     * changed since the last frame have their bounds updated.
+     */
     class RenderSystem final : public ecs_config::ISystem
     {
     public:
-        using Components = std::tuple<Renderable, Transform>;
+        using Components = std::tuple<const Renderable, const Transform>;
+        using Access     = std::tuple<const Camera, const Renderable, const Transform>;
+
+        // the OpenGL context is current on the main thread only
+        static constexpr bool main_thread = true;
 
         ~RenderSystem() override = default;
 
@@ -22,16 +50,51 @@ namespace nexus
 
         void update(
             ecs_config::Coordinator&     context,
-            const std::set<ecs::Entity>& entities,
+            std::span<const ecs::Entity> entities,
             ecs::Duration                frame_time
         ) override;
 
+        const CullingStats& culling_stats() const { return m_culling_stats; }
+
     private:
-        void draw();
+        // the std140 `Frame` block of the shaders
+        struct FrameUniforms
+        {
+            glm::mat4 m_view;
+            glm::mat4 m_projection;
+        };
+
+        static_assert(sizeof(FrameUniforms) == 2 * 16 * sizeof(float), "std140 has no padding here");
+
+        static constexpr gl::GLuint frame_binding = 0;
+
+        // the fastest bodies move a couple of units per frame, so most frames don't reinsert anything
+        static constexpr float bvh_margin = 2.0f;
+
+        void cull(
+            ecs_config::Coordinator&     context,
+            std::span<const ecs::Entity> entities,
+            const glm::mat4&             view_projection
+        );
 
         glfw_cpp::Window& m_render_context;
         ecs::Entity       m_camera;
         CubePrimitive     m_cube;
+        InstanceBuffer    m_instance_buffer;
         Shader            m_shader;
+
+        UniformBuffer<FrameUniforms> m_frame_uniforms;
+
+        spatial::Bvh                     m_bvh{ bvh_margin };
+        std::vector<spatial::Bvh::Proxy> m_proxies;      // by entity index, null if not in the hierarchy
+        std::vector<std::uint64_t>       m_last_seen;    // by entity index, the last frame it was drawable
+        std::vector<spatial::Aabb>       m_bounds;       // of the renderables of the current frame
+        std::vector<std::uint8_t>        m_moved;        // whether their transform changed since the last one
+        std::vector<ecs::Entity>         m_visible;
+        std::uint64_t                    m_frame         = 0;
+        CullingStats                     m_culling_stats = {};
+
+        // per entity data of the current frame, built in parallel before uploading
+        std::vector<InstanceData> m_instances;
     };
 }
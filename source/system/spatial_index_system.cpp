@@ -0,0 +1,29 @@
+#include "spatial_index_system.hpp"
+
+#include <ecs/coordinator.hpp>
+
+namespace nexus
+{
+    SpatialIndexSystem::SpatialIndexSystem(ecs_config::Coordinator& coordinator)
+        : m_grid{ cell_size }
+    {
+        // also invoked for the entities being destroyed
+        coordinator.on_remove<Transform>([this](ecs::Entity entity, const Transform&) {
+            m_grid.remove(entity);
+        });
+    }
+
+    void SpatialIndexSystem::update(
+        ecs_config::Coordinator&     context,
+        std::span<const ecs::Entity> /* entities */,
+        ecs::Duration /* frame_time */
+    )
+    {
+        // only the transforms changed since the last run are read, and of those only the entities that
+        // crossed into another cell are relinked
+        auto changed = context.view<const Transform>().changed<Transform>(last_run());
+        changed.each([&](ecs::Entity entity, ecs::SoaRef<const Transform> transform) {
+            m_grid.update(entity, transform.get<&Transform::m_position>());
+        });
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "component/transform.hpp"
+#include "spatial/hash_grid.hpp"
+#include "ecs_config.hpp"
+
+#include <span>
+#include <tuple>
+
+namespace nexus
+{
+    /**
+     * @brief Keeps a hash grid of the positions of every entity with a `Transform` for proximity queries.
+     *
+     * Systems that need it get it from here, e.g. `index.grid().query_radius(center, radius)`; ordering them
+     * after this one makes them see the positions of the current frame. Only the entities whose transform
+     * changed since the last update are visited, and the ones losing it are removed as it happens.
+     */
+    class SpatialIndexSystem final : public ecs_config::ISystem
+    {
+    public:
+        using Components = std::tuple<const Transform>;
+
+        static constexpr float cell_size = 10.0f;
+
+        explicit SpatialIndexSystem(ecs_config::Coordinator& coordinator);
+
+        ~SpatialIndexSystem() override = default;
+
+        void update(
+            ecs_config::Coordinator&     context,
+            std::span<const ecs::Entity> entities,
+            ecs::Duration                frame_time
+        ) override;
+
+        const spatial::HashGrid& grid() const { return m_grid; }
+
+    private:
+        spatial::HashGrid m_grid;
+    };
+}
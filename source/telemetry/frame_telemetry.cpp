@@ -0,0 +1,105 @@
+#include "frame_telemetry.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <print>
+
+namespace nexus::telemetry
+{
+    FrameTelemetry::FrameTelemetry(std::FILE* output, ecs::Duration interval)
+        : m_output{ output }
+        , m_interval{ interval }
+        , m_thread{ [this](std::stop_token stop) { drain(stop); } }
+    {
+    }
+
+    FrameTelemetry::~FrameTelemetry()
+    {
+        m_thread.request_stop();
+        m_thread.join();
+    }
+
+    void FrameTelemetry::drain(std::stop_token stop)
+    {
+        // polling, a wake-up from the frame loop would make it do a syscall
+        constexpr auto poll_interval = std::chrono::milliseconds{ 10 };
+
+        auto accumulated = ecs::Duration{ 0 };
+
+        auto take = [&] {
+            while (auto sample = m_ring.pop()) {
+                m_window.push_back(*sample);
+                accumulated += sample->m_frame_time;
+
+                if (accumulated >= m_interval) {
+                    emit();
+                    accumulated = ecs::Duration{ 0 };
+                }
+            }
+        };
+
+        while (not stop.stop_requested()) {
+            take();
+            std::this_thread::sleep_for(poll_interval);
+        }
+
+        take();
+        emit();
+    }
+
+    void FrameTelemetry::emit()
+    {
+        if (m_window.empty()) {
+            return;
+        }
+
+        m_frame_times.clear();
+        auto total   = ecs::Duration{ 0 };
+        auto visible = 0.0;
+        auto culled  = 0.0;
+        auto visited = 0.0;
+        auto moved   = 0.0;
+        auto pairs   = 0.0;
+
+        for (const auto& sample : m_window) {
+            m_frame_times.push_back(sample.m_frame_time);
+            total   += sample.m_frame_time;
+            visible += sample.m_visible;
+            culled  += sample.m_culled;
+            visited += sample.m_nodes_visited;
+            moved   += sample.m_reinserted;
+            pairs   += sample.m_pairs;
+        }
+
+        std::ranges::sort(m_frame_times);
+
+        auto count = static_cast<double>(m_window.size());
+        auto ms    = [](ecs::Duration duration) { return duration.count() * 1000.0f; };
+        auto at    = [&](double fraction) {
+            auto index = static_cast<std::size_t>(fraction * (count - 1.0));
+            return ms(m_frame_times[index]);
+        };
+
+        std::println(
+            m_output,
+            "frames: {} | frame ms min/avg/p50/p99/max: {:.2f}/{:.2f}/{:.2f}/{:.2f}/{:.2f} | "
+            "visible: {:.0f}, culled: {:.0f}, nodes visited: {:.0f}, reinserted: {:.0f} | pairs: {:.0f} | "
+            "dropped: {}",
+            m_window.size(),
+            ms(m_frame_times.front()),
+            ms(total) / count,
+            at(0.50),
+            at(0.99),
+            ms(m_frame_times.back()),
+            visible / count,
+            culled / count,
+            visited / count,
+            moved / count,
+            pairs / count,
+            m_dropped.exchange(0, std::memory_order_relaxed)
+        );
+        std::fflush(m_output);
+
+        m_window.clear();
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "telemetry/spsc_ring.hpp"
+
+#include <ecs/common.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace nexus::telemetry
+{
+    // what nexus reports about a frame
+    struct FrameSample
+    {
+        ecs::Duration m_frame_time;
+        std::uint32_t m_visible;
+        std::uint32_t m_culled;
+        std::uint32_t m_nodes_visited;
+        std::uint32_t m_reinserted;
+        std::uint32_t m_pairs;
+    };
+
+    /**
+     * @brief Reports frame statistics from a background thread, so the frame loop never waits on output.
+     *
+     * The frame loop hands each sample over through a lock-free ring. A background thread drains it, and
+     * every `interval` of frame time writes one line with the frame count, the min/avg/p50/p99/max frame
+     * time, and the averages of the other statistics. When the ring is full the sample is dropped and
+     * counted instead of waiting.
+     */
+    class FrameTelemetry
+    {
+    public:
+        static constexpr std::size_t ring_capacity = 1024;
+
+        explicit FrameTelemetry(std::FILE* output, ecs::Duration interval = std::chrono::seconds{ 1 });
+
+        // the samples still in the ring are reported before returning
+        ~FrameTelemetry();
+
+        FrameTelemetry(FrameTelemetry&&)            = delete;
+        FrameTelemetry& operator=(FrameTelemetry&&) = delete;
+
+        // never blocks, from the frame loop only
+        void record(const FrameSample& sample)
+        {
+            if (not m_ring.push(sample)) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        void drain(std::stop_token stop);
+        void emit();
+
+        SpscRing<FrameSample, ring_capacity> m_ring;
+        std::atomic<std::uint64_t>           m_dropped = 0;
+
+        // owned by the background thread
+        std::FILE*                 m_output;
+        ecs::Duration              m_interval;
+        std::vector<FrameSample>   m_window;
+        std::vector<ecs::Duration> m_frame_times;
+
+        std::jthread m_thread;    // last, so that it stops before the rest is destroyed
+    };
+}
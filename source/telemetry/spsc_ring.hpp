@@ -0,0 +1,80 @@
+#pragma once
+
+#include <ecs/config.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+
+namespace nexus::telemetry
+{
+    /**
+     * @brief A bounded lock-free queue between one producer thread and one consumer thread.
+     *
+     * Neither side ever blocks or allocates: pushing to a full ring fails instead. The indices only grow and
+     * are masked into the slots. Each side also keeps a copy of the other side's index and only reloads it
+     * when the copy says the ring is full or empty, so they rarely touch each other's cache line.
+     *
+     * @tparam T The element type, trivially copyable so a slot can be overwritten at any time.
+     * @tparam Capacity Number of slots, a power of two.
+     */
+    template <typename T, std::size_t Capacity>
+        requires std::is_trivially_copyable_v<T> and (Capacity > 0 and (Capacity & (Capacity - 1)) == 0)
+    class SpscRing
+    {
+    public:
+        // producer only
+        bool push(const T& value)
+        {
+            auto head = m_head.load(std::memory_order_relaxed);
+
+            if (head - m_cached_tail == Capacity) {
+                m_cached_tail = m_tail.load(std::memory_order_acquire);
+                if (head - m_cached_tail == Capacity) {
+                    return false;
+                }
+            }
+
+            m_slots[head & mask] = value;
+            m_head.store(head + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        // consumer only
+        std::optional<T> pop()
+        {
+            auto tail = m_tail.load(std::memory_order_relaxed);
+
+            if (tail == m_cached_head) {
+                m_cached_head = m_head.load(std::memory_order_acquire);
+                if (tail == m_cached_head) {
+                    return std::nullopt;
+                }
+            }
+
+            auto value = m_slots[tail & mask];
+            m_tail.store(tail + 1, std::memory_order_release);
+
+            return value;
+        }
+
+        static constexpr std::size_t capacity() { return Capacity; }
+
+    private:
+        static constexpr std::size_t mask      = Capacity - 1;
+        static constexpr std::size_t alignment = ecs::config::cache_line_size;
+
+        // written by the producer
+        alignas(alignment) std::atomic<std::size_t> m_head        = 0;
+        std::size_t                                 m_cached_tail = 0;
+
+        // written by the consumer
+        alignas(alignment) std::atomic<std::size_t> m_tail        = 0;
+        std::size_t                                 m_cached_head = 0;
+
+        alignas(alignment) std::array<T, Capacity> m_slots = {};
+    };
+}
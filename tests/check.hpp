@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdio>
+#include <print>
+#include <source_location>
+
+namespace check
+{
+    // number of checks failed so far, returned by the tests' `main`
+    inline int& failures()
+    {
+        static auto failures = 0;
+        return failures;
+    }
+
+    /**
+     * @brief Report a failure if a condition does not hold, the test goes on.
+     */
+    inline void expect(bool condition, std::source_location location = std::source_location::current())
+    {
+        if (not condition) {
+            ++failures();
+            std::println(stderr, "{}:{}: check failed", location.file_name(), location.line());
+        }
+    }
+}
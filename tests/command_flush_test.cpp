@@ -0,0 +1,86 @@
+#include "check.hpp"
+
+#include <ecs/coordinator.hpp>
+
+#include <vector>
+
+namespace
+{
+    struct A
+    {
+        int m_value;
+    };
+
+    struct B
+    {
+        int m_value;
+    };
+
+    // big enough for the commands recorded by a single observer to outgrow the buffer's storage
+    struct C
+    {
+        double m_values[8];
+    };
+
+    // observers recording commands while the coordinator applies the ones they were invoked by
+    template <typename Coordinator>
+    void observers_record_while_flushing()
+    {
+        auto coordinator = Coordinator{};
+
+        coordinator.template on_add<A>([&](ecs::Entity entity, const A& a) {
+            coordinator.commands().add_component(entity, B{ a.m_value * 2 });
+            for (auto i = 0; i < 64; ++i) {
+                coordinator.commands().add_component(entity, C{ { static_cast<double>(i) } });
+            }
+        });
+        coordinator.template on_add<B>([&](ecs::Entity entity, const B&) {
+            coordinator.commands().add_component(entity, C{ { 7.0 } });
+        });
+
+        auto entities = std::vector<ecs::Entity>{};
+        for (auto i = 0; i < 200; ++i) {
+            auto entity = coordinator.create_entity();
+            entities.push_back(entity);
+            coordinator.commands().add_component(entity, A{ i });
+            coordinator.commands().add_component(entity, C{ { -1.0 } });
+        }
+
+        // the commands recorded by the observers are applied by the same flush, in the order recorded
+        coordinator.flush_commands();
+        check::expect(coordinator.commands().empty());
+
+        for (auto i = 0; i < 200; ++i) {
+            auto entity = entities[static_cast<std::size_t>(i)];
+            check::expect(coordinator.template has_component<B>(entity));
+            check::expect(coordinator.template has_component<C>(entity));
+
+            if (coordinator.template has_component<B>(entity)) {
+                check::expect(coordinator.template get_component<const B>(entity).m_value == i * 2);
+            }
+            if (coordinator.template has_component<C>(entity)) {
+                check::expect(coordinator.template get_component<const C>(entity).m_values[0] == 7.0);
+            }
+        }
+
+        // those of a buffer not owned by the coordinator are left for `flush_commands`
+        auto buffer = typename Coordinator::CommandBuffer{};
+        auto entity = coordinator.create_entity();
+        buffer.add_component(entity, A{ 5 });
+        coordinator.flush(buffer);
+
+        check::expect(coordinator.template has_component<A>(entity));
+        check::expect(not coordinator.template has_component<B>(entity));
+
+        coordinator.flush_commands();
+        check::expect(coordinator.template has_component<B>(entity));
+        check::expect(coordinator.template get_component<const C>(entity).m_values[0] == 7.0);
+    }
+}
+
+int main()
+{
+    observers_record_while_flushing<ecs::Coordinator<A, B, C>>();
+    observers_record_while_flushing<ecs::ArchetypeCoordinator<A, B, C>>();
+    return check::failures();
+}
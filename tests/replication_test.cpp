@@ -0,0 +1,184 @@
+#include "check.hpp"
+
+#include <ecs/coordinator.hpp>
+#include <ecs/quantize.hpp>
+#include <ecs/replication.hpp>
+#include <ecs/soa.hpp>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace
+{
+    struct Position
+    {
+        float m_x;
+        float m_y;
+        float m_z;
+    };
+
+    struct Velocity
+    {
+        float m_x;
+        float m_y;
+    };
+
+    struct Health
+    {
+        int m_value;
+        int m_armor;
+    };
+
+    struct Frozen
+    {
+    };
+}
+
+template <>
+struct ecs::Quantize<Position>
+{
+    static constexpr float step = 1.0f / 256.0f;
+};
+
+template <>
+struct ecs::SoaLayout<Velocity> : ecs::SoaFields<&Velocity::m_x, &Velocity::m_y>
+{
+};
+
+template <>
+struct ecs::IsTag<Frozen> : std::true_type
+{
+};
+
+namespace
+{
+    constexpr auto entity_count = 300;
+    constexpr auto frame_count  = 60;
+
+    template <typename Coordinator>
+    class World
+    {
+    public:
+        explicit World(std::uint32_t seed)
+            : m_random{ seed }
+        {
+            for (auto i = 0; i < entity_count; ++i) {
+                spawn();
+            }
+        }
+
+        // move every entity, and destroy, create, and change the components of a few
+        void step()
+        {
+            auto move = [&](Position& position, ecs::SoaRef<const Velocity> velocity) {
+                position.m_x += velocity.template get<&Velocity::m_x>() * uniform(0.0f, 0.1f);
+                position.m_y += velocity.template get<&Velocity::m_y>() * uniform(0.0f, 0.1f);
+                position.m_z += uniform(-0.001f, 0.001f);
+            };
+            m_coordinator.template view<Position, const Velocity>().each(move);
+
+            for (auto& entity : m_entities) {
+                auto roll = uniform(0.0f, 1.0f);
+                if (roll < 0.05f) {
+                    m_coordinator.destroy_entity(entity);
+                    entity = spawn_components(m_coordinator.create_entity());
+                } else if (roll < 0.08f) {
+                    toggle<Frozen>(entity);
+                } else if (roll < 0.10f) {
+                    toggle<Health>(entity);
+                } else if (roll < 0.15f and m_coordinator.template has_component<Health>(entity)) {
+                    m_coordinator.template get_component<Health>(entity).m_value -= 1;
+                }
+            }
+        }
+
+        Coordinator&                    coordinator() { return m_coordinator; }
+        const std::vector<ecs::Entity>& entities() const { return m_entities; }
+
+    private:
+        void spawn() { m_entities.push_back(spawn_components(m_coordinator.create_entity())); }
+
+        ecs::Entity spawn_components(ecs::Entity entity)
+        {
+            auto position = Position{ uniform(-10, 10), uniform(-10, 10), uniform(0, 1) };
+            m_coordinator.add_component(entity, position);
+            if (uniform(0.0f, 1.0f) < 0.8f) {
+                m_coordinator.add_component(entity, Velocity{ uniform(-1, 1), uniform(-1, 1) });
+            }
+            if (uniform(0.0f, 1.0f) < 0.5f) {
+                m_coordinator.add_component(entity, Health{ 100, static_cast<int>(m_random() % 10) });
+            }
+            return entity;
+        }
+
+        template <typename Comp>
+        void toggle(ecs::Entity entity)
+        {
+            if (m_coordinator.template has_component<Comp>(entity)) {
+                m_coordinator.template remove_component<Comp>(entity);
+            } else {
+                m_coordinator.add_component(entity, Comp{});
+            }
+        }
+
+        float uniform(float min, float max) { return std::uniform_real_distribution{ min, max }(m_random); }
+
+        Coordinator              m_coordinator;
+        std::vector<ecs::Entity> m_entities;
+        std::mt19937             m_random;
+    };
+
+    // replicate a world whose entities move, die, and respawn over a socket pair, comparing every frame
+    template <typename Coordinator>
+    void mirror_matches_source()
+    {
+        auto fds = std::array{ -1, -1 };
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()) != 0) {
+            check::expect(false);
+            return;
+        }
+
+        auto world  = World<Coordinator>{ 42 };
+        auto mirror = Coordinator{};
+        auto writer = ecs::ReplicationWriter<Coordinator>{};
+        auto reader = ecs::ReplicationReader<Coordinator>{};
+
+        for (auto frame = 0; frame < frame_count; ++frame) {
+            world.step();
+
+            // small enough to fit in the socket's buffer, so it can be read back on the same thread
+            check::expect(writer.write(world.coordinator(), ecs::replication::FdSink{ fds[0] }));
+            auto status = reader.read(ecs::replication::FdSource{ fds[1] }, mirror);
+            check::expect(status == ecs::ReplicationStatus::Ok);
+            check::expect(reader.mismatches(world.coordinator(), mirror) == 0);
+        }
+
+        // the check itself notices a value off by more than a step, and an entity the mirror has too many
+        auto entity   = world.entities().front();
+        auto mirrored = reader.local(entity);
+        check::expect(mirrored.has_value());
+
+        if (mirrored) {
+            mirror.template get_component<Position>(*mirrored).m_x += 2 * ecs::Quantize<Position>::step;
+            check::expect(reader.mismatches(world.coordinator(), mirror) == 1);
+        }
+
+        world.coordinator().destroy_entity(world.entities().back());
+        check::expect(reader.mismatches(world.coordinator(), mirror) == 2);
+
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+}
+
+int main()
+{
+    mirror_matches_source<ecs::Coordinator<Position, Velocity, Health, Frozen>>();
+    mirror_matches_source<ecs::ArchetypeCoordinator<Position, Velocity, Health, Frozen>>();
+    return check::failures();
+}
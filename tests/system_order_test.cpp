@@ -0,0 +1,77 @@
+#include "check.hpp"
+
+#include <ecs/coordinator.hpp>
+
+#include <mutex>
+#include <span>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    struct A
+    {
+        int m_value;
+    };
+
+    struct B
+    {
+        int m_value;
+    };
+
+    struct C
+    {
+        int m_value;
+    };
+
+    using Coordinator = ecs::Coordinator<A, B, C>;
+
+    // the systems that ran in the current frame, in the order they finished
+    std::mutex       g_mutex;
+    std::vector<int> g_finished;
+
+    // writes a component no other system accesses, so only the explicit orders serialize the systems
+    template <typename Comp, int Id>
+    struct WriteSystem : ecs::ISystem<Coordinator>
+    {
+        using Components = std::tuple<Comp>;
+
+        void update(Coordinator&, std::span<const ecs::Entity>, ecs::Duration) override
+        {
+            auto lock = std::scoped_lock{ g_mutex };
+            g_finished.push_back(Id);
+        }
+    };
+
+    void cyclic_orders_are_rejected()
+    {
+        auto coordinator = Coordinator{};
+
+        auto& first  = coordinator.create_system<WriteSystem<A, 0>>();
+        auto& second = coordinator.create_system<WriteSystem<B, 1>>();
+        auto& third  = coordinator.create_system<WriteSystem<C, 2>>();
+
+        check::expect(coordinator.order_systems(third, second));
+        check::expect(coordinator.order_systems(second, first));
+
+        check::expect(not coordinator.order_systems(first, third));
+        check::expect(not coordinator.order_systems(first, second));
+        check::expect(not coordinator.order_systems(first, first));
+
+        // a redundant order is not a cycle
+        check::expect(coordinator.order_systems(third, first));
+
+        // every system still runs, in the accepted order
+        for (auto frame = 0; frame < 10; ++frame) {
+            g_finished.clear();
+            coordinator.update(ecs::Duration{ 0 });
+            check::expect(g_finished == std::vector{ 2, 1, 0 });
+        }
+    }
+}
+
+int main()
+{
+    cyclic_orders_are_rejected();
+    return check::failures();
+}